@@ -8,69 +8,19 @@
 #include <algorithm>
 #include <climits>
 #include <map>
+#include <cstring>
+#include <cstdio>
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
 using namespace std;
 
-//Level order traversal using queue
-//O(n) time complexity, n = number of nodes in tree
-//visits node at each level and add children to queue similar to BFS
-template<class V>
-void levelOrder(treeNode* root){
-	treeNode* temp = root;
-	queue<treeNode*> q;
-	
-	while(temp){
-		cout << temp->data;
-
-		if(temp->left)
-			q.push(temp->left);
-
-		if(temp->right)
-			q.push(temp->right);
-
-		temp = q.pop;
-	}
-}
-
-//Level order traversal using queue in spiral using two stacks
-//O(n) time complexity, O(n) space, n = number of nodes in tree
-//visits node at each level and add children to two stacks to traverse in a spiral
-template<class V>
-void levelOrderSpiral(treeNode* root){
-	if (root == NULL)
-		return;
-
-	stack<treeNode*> toRight;
-	stack<treeNode*> toLeft;
-
-	toLeft.push(root);
-
-	while(!toRight.empty() || !toLeft.empty()){
-		while(!toRight.empty()){
-			treeNode* temp = toRight.top();
-			toRight.pop();
-			cout << temp->data << " ";
-
-			//add nodes in appropriate order to correctly traverse next level
-			if(temp->left)
-				toLeft.push(temp->left);
-			if(temp->right)
-				toLeft.push(temp->right);
-		}
-
-		while(!toLeft.empty()){
-			treeNode* temp = toLeft.top();
-			toLeft.pop();
-			cout << temp->data << " ";
-
-			//add nodes in appropriate order to correctly traverse next level
-			if(temp->right)
-				toLeft.push(temp->right);
-			if(temp->left)
-				toLeft.push(temp->left);
-		}
-	}
-}
-
 //Print duplicated elements in an integer array
 //O(n) time, O(1) space
 void printDuplicate(int arr[], int size){
@@ -82,23 +32,6 @@ void printDuplicate(int arr[], int size){
 	}
 }
 
-//Reverse a linked list
-//O(n) time, O(1) space
-template<class N>
-void reverseLinkedList(listNode* head){
-	listNode* prev = nullptr;
-	listNode* curr = head;
-	listNode* next;
-
-	while(curr){
-		next = curr->next;
-		curr->next = prev;
-		prev = curr;
-		curr = next;
-	}
-	head = prev;
-}
-
 //Checks whether string s1 and s2 are a rotation of each other
 bool isRotated(string s1, string s2){
 	if(s1.size() == s2.size()){
@@ -114,55 +47,22 @@ bool isRotated(string s1, string s2){
 //reverses a string
 //O(n) time
 void reverseString(char* str){
-	char* end = str;
-	char tmp;
-	if(str){
-		//find end of string
-		while(*end)
-			end++;
-		end--;
-
-		//swap characters at the start with the end, going inwards
-		while(str < end){
-			tmp = *str;
-			*str++ = *end;
-			*end-- = tmp;
-		}
-	}
+	if(str)
+		reverseBytes(str, strlen(str));
 }
 
 //reverses a string
 //O(n) time
 void reverseString(char* begin, char* end){
-	char tmp;
-	while(begin < end){
-		tmp = *begin;
-		*begin++ = *end;
-		*end-- = tmp;
-	}
+	if(begin < end)
+		reverseBytes(begin, end - begin + 1);
 }
 
 //reverses words in a string
 //O(n) time
 void reverseWords(char* str){
-	char *word_begin = NULL;
-    char *temp = str; 
- 
-    while(*temp){
-        /*make sure that the string start with
-          valid character (not space) only*/
-        if ((word_begin == NULL) && (*temp != ' ')){
-            word_begin=temp;
-        }
-        if(word_begin && ((*(temp+1) == ' ') || (*(temp+1) == '\0'))){
-            reverse(word_begin, temp);
-            word_begin = NULL;
-        }
-        temp++;
-    }
-
-	//reverse whole string after reversing each word
-    reverseString(str, temp-1);
+	if(str)
+		reverseWords(str, strlen(str));
 }
 
 //randomly shuffles elements of an array using the Fisher-Yates algorithm
@@ -202,6 +102,9 @@ bool isAnagram(string s1, string s2){
 //O(n) time
 string runLengthEncode(string s){
 	int n = s.size();
+	if(n == 0)
+		return s;
+
 	int i;
 	int count = 1;
 	char prev = s[0];
@@ -212,288 +115,19 @@ string runLengthEncode(string s){
 			count++;
 		else{
 			res += prev;
-			res += char(count + 48);
+			res += to_string(count);
 			count = 1;
 			prev = s[i];
 		}
 	}
 	res += prev;
-	res += char(count + 48);
+	res += to_string(count);
 
 	if(res.size() > n)
 		return s;
 	return res;
 }
 
-//removes duplicates from an unsorted linked list
-//O(n) time
-template<class N>
-void removeDuplicates(listNode* node){
-	set<int> listData;
-	listNode* prev = nullptr;
-
-	while(node != nullptr){
-		if(listData.find(node->data) != listData.end())
-			prev->next = node->next;
-		else{
-			listData.emplace(node->data);
-			prev = node;
-		}
-		node = node->next;
-	}
-}
-
-//finds the kth to last element of a singly linked list
-//O(n) time
-template<class N>
-listNode* kthToLastOfList(listNode* head, int k){
-	if(k <= 0) 
-		return nullptr;
-
-	listNode* r1 = head;
-	listNode* r2 = head;
-
-	for(int i = 0; i < k-1; i++){
-		if(r2 == nullptr)
-			return nullptr;
-		r2 = r2->next;
-	}
-	if(r2 == nullptr)
-		return nullptr;
-
-	while(r2->next != nullptr){
-		r1 = r1->next;
-		r2 = r2->next;
-	}
-	return r1;
-}
-
-//deletes a node in the middle of a singly linked list, given only access to that node
-template<class N>
-bool deleteListNode(listNode* node){
-	if(node == nullptr || node->next == nullptr)
-		return false;
-
-	//copies next node's data to current node and delete next node
-	listNode* next = node->next;
-	node->data = next->data;
-	node->next = next->next;
-	return true;
-}
-
-//finds beginning of loop in a circular linked list
-template<class N>
-listNode* findBegin(listNode* head){
-	listNode* slow = head;
-	listNode* fast = head;
-
-	//slow travels 1 node while fast travels 2 nodes at a time
-	//when they collide, break and set slow to head
-	while(fast != nullptr && fast->next != nullptr){
-		slow = slow->next;
-		fast = fast->next->next;
-		if(slow == fast)
-			break;
-	}
-
-	if(fast == nullptr && fast->next == nullptr)
-		return nullptr;
-	
-	slow = head;
-	
-	//both slow and fast travel 1 node at a time and when they collide, they're at the beginning of the loop in the list
-	while(slow != fast){
-		slow = slow->next;
-		fast = fast->next;
-	}
-	return fast;
-}
-
-//determines whether a binary tree is balanced
-//O(n) time
-template<class V>
-bool isBalanced(treeNode* root, int& height){
-	int leftHeight = 0;
-	int rightHeight = 0;
-
-	bool leftBal = false;
-	bool rightBal = false;
-
-	if(root == nullptr){
-		height = 0;
-		return true;
-	}
-
-	//recur for subtrees
-	leftBal = isBalanced(root->left, leftHeight);
-	rightBal = isBalanced(root->right, rightHeight);
-
-	height = max(leftHeight, rightHeight) + 1;
-
-	//not balanced
-	if((leftHeight - rightHeight > 1) || (rightHeight - leftHeight > 1))
-		return false;
-	//balanced if subtrees and current tree are balanced
-	else
-		return (leftBal && rightBal);
-}
-
-//determines whether n1 and n2 are connected within the graph (BFS)
-template<class G>
-bool isConnected(graphNode* n1, graphNode* n2){
-	if(n1 == n2)
-		return true;
-
-	queue<graphNode*> nodes;
-	nodes.push(n1);
-	graphNode* temp;
-
-	while(!nodes.empty()){
-		temp = nodes.pop();
-		if(temp != nullptr){
-			for(graphNode* i : nodes){
-				if(!(i->visited)){
-					if(i == n2)
-						return true;
-					else{
-						i->visited = true;
-						nodes.push(i);
-					}
-				}
-			}
-			temp->visited = true;
-		}
-	}
-	return false;
-}
-
-//creates a linked list for all the nodes at the level specified
-template<class V>
-void createLevelLinkedList(treeNode* root, listNode* head, int level){
-	if(root == nullptr || level < 0)
-			return;
-	
-	//at right level so add node to linked list
-	if(level == 0){
-		listNode* temp = new listNode();
-		temp->next = head->next;
-		temp->data = root->data;
-		head->next = temp;
-	}
-
-	//recur tree, starting with right first because we're inserting to beginning of linked list
-	createLevelLinkedList(root->right, head, level-1);
-	createLevelLinkedList(root->left, head, level-1);
-}
-
-//determines whether a binary tree is a binary search tree using min/max algorithm
-//O(n) time
-template<class V>
-bool isBST(treeNode* root, int min, int max){
-	if(root == nullptr)
-		return true;
-
-	//check if data is within valid range
-	if(root->data <= min || root->data > max)
-		return false;
-
-	return (isBST(root->left, min, root->data) && isBST(root->right, root->data, max));
-}
-
-//returns the leftmost child in the tree starting at root
-//O(h) time, h = height of tree
-template<class V>
-treeNode* leftMostChild(treeNode* root){
-	if(root == nullptr)
-		return nullptr;
-	treeNode* curr = root;
-	while(curr->left != nullptr)
-		curr = curr->left;
-	return curr;
-}
-
-//finds the in-order successor to the given node in a BST (assuming node has parent pointer)
-template<class V>
-treeNode* inorderSucc(treeNode* root){
-	//if has right child, find leftmost child of right child
-	if(root->right != nullptr)
-		return leftMostChild(root->right);
-	//go up the tree until a node whose left child is this node
-	else{
-		treeNode* s = root;
-		treeNode* t = s->parent;
-		while(t != nullptr && s != t->left){
-			s = t;
-			t = t->parent;
-		}
-		return t;
-	}
-}
-
-//finds the in-order successor to the given node in a BST (assuming node has no parent pointer)
-template<class V>
-treeNode* inorderSucc(treeNode* root, treeNode* node){
-	//if has right child, find leftmost child of right child
-	if(node->right != nullptr)
-		return leftMostChild(node->right);
-	
-	//traverse down from root to find succ
-	treeNode* succ = nullptr;
-	while(root != nullptr){
-		if(node->data < root->data){
-			succ = root;
-			root = root->left;
-		}
-		else if(node->data > root->data)
-			root = root->right;
-		else
-			break;
-	}
-	return succ;
-}
-
-//finds the lowest common ancestor of n1 and n2 in a binary tree
-//O(n) time
-template<class V>
-treeNode* BT_LCA(treeNode* root, treeNode* n1, treeNode* n2){
-	if(root == nullptr)
-		return nullptr;
-
-	//found node in tree
-	if(root->data == n1->data || root->data == n2->data)
-		return root;
-
-	//recur left and right
-	treeNode* left = BT_LCA(root->left, n1, n2);
-	treeNode* right = BT_LCA(root->right, n1, n2);
-
-	//if found in both left and right subtrees, this node must be the LCA
-	if(left && right)
-		return root;
-
-	//if only found in 1 subtree, returned node must be LCA
-	if(left != nullptr)
-		return left;
-	else
-		return right;
-}
-
-//finds the lowest common ancestor of n1 and n2 in a binary search tree
-//O(h) time
-template<class V>
-treeNode* BST_LCA(treeNode* root, treeNode* n1, treeNode* n2){
-	//use property of BST to find LCA
-	while(root != nullptr){
-		if(n1->data < root->data && n2->data < root->data)
-			root = root->left;
-		else if(n1->data > root->data && n2->data > root->data)
-			root = root->right;
-		else
-			break;
-	}
-	return root;
-}
-
 //determines whether two trees match each other
 template<class V>
 bool treeMatch(treeNode* t1, treeNode* t2){
@@ -513,22 +147,6 @@ bool treeMatch(treeNode* t1, treeNode* t2){
 		return (treeMatch(t1->left, t2->left) && treeMatch(t1->right, t2->right));
 }
 
-//determines whether t1 contains t2 as a subtree
-template<class V>
-bool containsTree(treeNode* t1, treeNode* t2){
-	if(t2 == nullptr)
-		return true;
-	if(t1 == nullptr)
-		return false;
-	//matching data so check if subtrees match
-	if(t1->data == t2->data){
-		if(treeMatch(t1, t2))
-			return true;
-	}
-	//recur for left and right
-	return (containsTree(t1->left, t2) || containsTree(t1->right, t2));
-}
-
 //updates bits i to j of n with m (length of m is guaranteed to be correct)
 int updateBits(int n, int m, int i, int j){
 	int allOnes = ~0;
@@ -600,22 +218,13 @@ string insertCharAt(string s, char c, int pos){
 //O(n!) time
 vector<string> computePerms(string s){
 	vector<string> perms;
-	//base case
-	if(s.size() == 0){
-		perms.push_back("");
-		return perms;
-	}
 
-	//insert first char into each possible position
-	char first = s.at(0);
-	string remainder = s.substr(1);
-	vector<string> words = computePerms(remainder);
-	for(string word : words){
-		for(int i = 0; i < words.size(); i++){
-			string perm = insertCharAt(s, first, i);
-			perms.push_back(perm);
-		}
-	}
+	// step through lexicographic order in place, starting from the smallest arrangement
+	sort(s.begin(), s.end());
+	do{
+		perms.push_back(s);
+	}while(nextPermutation(&s[0], s.size()));
+
 	return perms;
 }
 
@@ -973,31 +582,6 @@ void mergeSort(int arr[], int start, int end){
 	}
 }
 
-//finds intersection point of two singly linked lists
-//O(n+m) time, n and m are sizes of the linked lists
-template<class N>
-int findIntersection(listNode* h1, listNode* h2){
-	if(h1 == nullptr || h2 == nullptr)
-		return -1;
-
-	set<listNode*> visited;
-	listNode* temp = h1;
-	//add traversed nodes of h1 to set
-	while(temp != nullptr){
-		visited.insert(temp);
-		temp = temp->next;
-	}
-
-	temp = h2;
-	//if found node of h2 in set then we found intersection
-	while(temp != nullptr){
-		if(visited.find(temp) != set::end)
-			return temp->data;
-		temp = temp->next;
-	}
-	return -1;
-}
-
 //finds longest increasing subsequence of arr
 //b holds predecessor of arr[k] in longest subsequence
 //c[i] holds index of last element of longest increasing subsequence of length i in arr
@@ -1040,28 +624,6 @@ int* longestIncSeq(int arr[], int size){
 	return res;
 }
 
-//returns a random number from a list
-//uses reservoir sampling technique
-template<class N>
-int findRandom(listNode* head){
-	if(head == nullptr)
-		return -1;
-
-	//different seed each program
-	srand(time(0));
-
-	int res = head->data;
-	listNode* temp = head;
-	for(int i = 2; temp != nullptr; i++){
-		//change res with probability of 1/i
-		if(rand() % i == 0)
-			res = temp->data;
-		//move to next node
-		temp = temp->next;
-	}
-	return res;
-}
-
 //finds the maximum path sum in a binary tree
 template<class V>
 int maxPathSum(treeNode* root, int& maxSum){
@@ -1274,35 +836,9 @@ void commonNodesBSTs(treeNode* r1, treeNode* r2){
 
 //returns the next lexicographically greater string than s
 string nextPermutation(string s){
-	int size = s.size();
-	int suffix = size - 1;
-	// find beginning of latest suffix (sequence of non-increasing chars)
-	while(suffix > 0 && s[suffix] <= s[suffix-1])
-		suffix--;
-
 	// greatest lexicographically ordered string
-	if(suffix == 0)
+	if(s.empty() || !nextPermutation(&s[0], s.size()))
 		return "no such string exists";
-
-	// find smallest order char that is greater than pivot (suffix-1) to swap
-	int i = size - 1;
-	while(s[i] <= s[suffix-1])
-		i--;
-
-	// swap pivot and s[i]
-	char tmp = s[i];
-	s[i] = s[suffix-1];
-	s[suffix-1] = tmp;
-
-	// reverse suffix and return string
-	i = size - 1;
-	while(suffix < i){
-		tmp = s[suffix];
-		s[suffix] = s[i];
-		s[i] = tmp;
-		i--;
-		suffix++;
-	}
 	return s;
 }
 
@@ -1379,70 +915,24 @@ int maxRotatedSum(int a[], int n){
 	return maxSum;
 }
 
-// helper for printLeftView
-template<class V>
-void leftViewHelper(treeNode* root, int level, int& maxLevel){
-	if(root == nullptr)
-		return;
-
-	// first node in level so print it since we're traversing left nodes first
-	if(maxLevel < level){
-		cout << root->data;
-		maxLevel = level;
-	}
-
-	// recur for left and right subtrees
-	leftViewHelper(root->left, level+1, maxLevel);
-	leftViewHelper(root->right, level+1, maxLevel);
-}
-
-//prints the nodes of a binary tree seen from the left view
-//right view is done similarly but opposite recursive calls
-template<class V>
-void printLeftView(treeNode* root){
-	int maxLevel = 0;
-	leftViewHelper(root, 1, maxLevel);
-}
-
 //removes whitespaces from a string
 // O(n) time
 void removeSpaces(string& s){
-	int nextChar = 0;
-
-	for(int i = 0; i < s.size(); i++){
-		if(s[i] != ' '){
-			s[nextChar] = s[i];
-			nextChar++;
-		}
-	}
-}
-
-// helper for isNumPalindrome
-bool isNumPalHelper(int num, int& copy){
-	// base case
-	if(num >= 0 && num < 10)
-		return (num == (copy % 10));
-
-	// recursive call
-	if(!isNumPalHelper(num/10, copy))
-		return false;
-
-	// moving up recursive tree to check digits in the middle
-	copy /= 10;
-
-	// check equality for ith digit of num from the start with ith digit of copy from the end
-	return (num % 10 == copy % 10);
+	if(!s.empty())
+		s.resize(removeSpaces(&s[0], s.size()));
 }
 
 // determines whether num is palindromic
 bool isNumPalindrome(int num){
-	// if negative, make positive
-	if(num < 0)
-		num = -num;
+	// if negative, make positive (use unsigned so INT_MIN doesn't overflow)
+	unsigned int n = num < 0 ? 0u - (unsigned int)num : (unsigned int)num;
 
-	int numCopy = num;
+	// build the digits of n in reverse order and compare
+	unsigned long long reversed = 0;
+	for(unsigned int tmp = n; tmp > 0; tmp /= 10)
+		reversed = reversed * 10 + tmp % 10;
 
-	return isNumPalHelper(num, numCopy);
+	return reversed == n;
 }
 
 //returns the maximum product of a subarray in a
@@ -1482,33 +972,6 @@ int maxProductSubarray(int a[], int n){
     return maxProd;
 }
 
-//reverse a singly linked list in groups of k nodes
-//O(n) time
-template<class N>
-void reverseListByK(listNode* head, int k){
-	listNode* curr = head;
-    listNode* next = nullptr;
-    listNode* prev = nullptr;
-    int count = 0;   
-     
-    // reverse first k nodes of the linked list starting from head
-    while(curr != nullptr && count < k){
-       next  = curr->next;
-       curr->next = prev;
-       prev = curr;
-       curr = next;
-       count++;
-    }
-     
-    // recur for next group of k nodes
-    if(next != nullptr){  
-		head->next = reverseListByK(next, k); 
-	}
- 
-    // prev is the new head of reversed list
-    return prev;
-}
-
 //returns the length of the longest substring of s with unique characters
 //O(n) time
 int longestUniqueSubstring(string s){
@@ -1703,25 +1166,11 @@ bool isHeap(int a[], int i, int n) {
 }
 
 // returns the length of the longest common substring of s1 and s2
-// O(s1Size + s2Size)
+// uses a suffix automaton of s1
+// O(s1Size + s2Size) time
 int longestCommonSubstr(const string& s1, const string& s2) {
-	int dp[100][100];
-	int longest = 0;
-
-	for (int i = 0; i <= s1.size(); i++) {
-		for (int j = 0; j <= s2.size(); j++) {
-			if (i == 0 || j == 0)
-				dp[i][j] = 0;
-			else if (s1[i - 1] == s2[j - 1]) {
-				dp[i][j] = dp[i - 1][j - 1] + 1;
-				longest = max(longest, dp[i][j]);
-			}
-			else
-				dp[i][j] = 0;
-		}
-	}
-
-	return longest;
+	suffixAutomaton sam(s1);
+	return sam.longestCommonSubstr(s2);
 }
 
 // returns whether n is a Fibonacci number
@@ -1734,3 +1183,3008 @@ bool isFibonacci(int n) {
 
 	return (sqrtA * sqrtA == a || sqrtB * sqrtB == b);
 }
+
+// induced sorting step of SA-IS, places LMS suffixes then induces L and S types
+static void saisInduce(const vector<int>& s, const vector<bool>& isS, const vector<int>& lms,
+		const vector<int>& sumL, const vector<int>& sumS, vector<int>& sa) {
+	int n = s.size();
+	vector<int> buf(sumS);
+	fill(sa.begin(), sa.end(), -1);
+
+	// LMS suffixes go to the ends of their buckets
+	for (size_t i = 0; i < lms.size(); i++) {
+		if (lms[i] != n)
+			sa[buf[s[lms[i]]]++] = lms[i];
+	}
+
+	// induce L-type suffixes left to right
+	buf = sumL;
+	sa[buf[s[n - 1]]++] = n - 1;
+	for (int i = 0; i < n; i++) {
+		int v = sa[i];
+		if (v >= 1 && !isS[v - 1])
+			sa[buf[s[v - 1]]++] = v - 1;
+	}
+
+	// induce S-type suffixes right to left
+	buf = sumL;
+	for (int i = n - 1; i >= 0; i--) {
+		int v = sa[i];
+		if (v >= 1 && isS[v - 1])
+			sa[--buf[s[v - 1] + 1]] = v - 1;
+	}
+}
+
+// SA-IS over an integer alphabet [0, upper]
+static vector<int> saisHelper(const vector<int>& s, int upper) {
+	int n = s.size();
+	if (n == 0)
+		return vector<int>();
+	if (n == 1)
+		return vector<int>(1, 0);
+	if (n == 2)
+		return (s[0] < s[1]) ? vector<int>{0, 1} : vector<int>{1, 0};
+
+	// classify suffixes as S-type (smaller than next suffix) or L-type
+	vector<int> sa(n);
+	vector<bool> isS(n, false);
+	for (int i = n - 2; i >= 0; i--)
+		isS[i] = (s[i] == s[i + 1]) ? isS[i + 1] : (s[i] < s[i + 1]);
+
+	// bucket boundaries for each character
+	vector<int> sumL(upper + 1, 0);
+	vector<int> sumS(upper + 1, 0);
+	for (int i = 0; i < n; i++) {
+		if (!isS[i])
+			sumS[s[i]]++;
+		else
+			sumL[s[i] + 1]++;
+	}
+	for (int i = 0; i <= upper; i++) {
+		sumS[i] += sumL[i];
+		if (i < upper)
+			sumL[i + 1] += sumS[i];
+	}
+
+	// leftmost S-type positions
+	vector<int> lmsMap(n + 1, -1);
+	vector<int> lms;
+	for (int i = 1; i < n; i++) {
+		if (!isS[i - 1] && isS[i]) {
+			lmsMap[i] = lms.size();
+			lms.push_back(i);
+		}
+	}
+	int m = lms.size();
+
+	saisInduce(s, isS, lms, sumL, sumS, sa);
+	if (m == 0)
+		return sa;
+
+	// name LMS substrings in sorted order
+	vector<int> sortedLms;
+	sortedLms.reserve(m);
+	for (int i = 0; i < n; i++) {
+		if (lmsMap[sa[i]] != -1)
+			sortedLms.push_back(sa[i]);
+	}
+
+	vector<int> reduced(m);
+	int recUpper = 0;
+	reduced[lmsMap[sortedLms[0]]] = 0;
+	for (int i = 1; i < m; i++) {
+		int l = sortedLms[i - 1];
+		int r = sortedLms[i];
+		int endL = (lmsMap[l] + 1 < m) ? lms[lmsMap[l] + 1] : n;
+		int endR = (lmsMap[r] + 1 < m) ? lms[lmsMap[r] + 1] : n;
+		bool same = true;
+		if (endL - l != endR - r)
+			same = false;
+		else {
+			while (l < endL && s[l] == s[r]) {
+				l++;
+				r++;
+			}
+			if (l == n || s[l] != s[r])
+				same = false;
+		}
+		if (!same)
+			recUpper++;
+		reduced[lmsMap[sortedLms[i]]] = recUpper;
+	}
+
+	// recursively sort the reduced string, then induce the full order from it
+	vector<int> reducedSa = saisHelper(reduced, recUpper);
+	for (int i = 0; i < m; i++)
+		sortedLms[i] = lms[reducedSa[i]];
+	saisInduce(s, isS, sortedLms, sumL, sumS, sa);
+	return sa;
+}
+
+//builds the suffix array of s using SA-IS (induced sorting)
+//O(n) time
+vector<int> buildSuffixArray(const string& s) {
+	vector<int> chars(s.size());
+	for (size_t i = 0; i < s.size(); i++)
+		chars[i] = (unsigned char)s[i];
+	return saisHelper(chars, 255);
+}
+
+//builds the longest common prefix array of s from its suffix array (Kasai's algorithm)
+//lcp[i] is the length of the common prefix of suffixes sa[i-1] and sa[i], lcp[0] = 0
+//O(n) time
+vector<int> buildLCPArray(const string& s, const vector<int>& sa) {
+	int n = s.size();
+	vector<int> rank(n);
+	vector<int> lcp(n, 0);
+	for (int i = 0; i < n; i++)
+		rank[sa[i]] = i;
+
+	// prefix length drops by at most 1 when moving to the next suffix in text order
+	int h = 0;
+	for (int i = 0; i < n; i++) {
+		if (rank[i] == 0) {
+			h = 0;
+			continue;
+		}
+		int j = sa[rank[i] - 1];
+		while (i + h < n && j + h < n && s[i + h] == s[j + h])
+			h++;
+		lcp[rank[i]] = h;
+		if (h > 0)
+			h--;
+	}
+	return lcp;
+}
+
+//returns the longest substring that occurs at least twice in s
+//O(n) time
+string longestRepeatedSubstr(const string& s) {
+	vector<int> sa = buildSuffixArray(s);
+	vector<int> lcp = buildLCPArray(s, sa);
+
+	int best = 0;
+	int pos = 0;
+	for (size_t i = 1; i < lcp.size(); i++) {
+		if (lcp[i] > best) {
+			best = lcp[i];
+			pos = sa[i];
+		}
+	}
+	return s.substr(pos, best);
+}
+
+//counts the distinct non-empty substrings of s
+//O(n) time
+long long countDistinctSubstrings(const string& s) {
+	vector<int> sa = buildSuffixArray(s);
+	vector<int> lcp = buildLCPArray(s, sa);
+
+	// every suffix adds its prefixes except the ones shared with the previous suffix
+	long long n = s.size();
+	long long count = n * (n + 1) / 2;
+	for (size_t i = 0; i < lcp.size(); i++)
+		count -= lcp[i];
+	return count;
+}
+
+// appends a length-prefixed array of ints to out
+template<class T>
+static void appendArray(string& out, const vector<T>& v) {
+	unsigned int size = v.size();
+	out.append((const char*)&size, sizeof(size));
+	if (size > 0)
+		out.append((const char*)v.data(), size * sizeof(T));
+}
+
+// reads a length-prefixed array written by appendArray into v, advancing pos
+// returns false if data ends before the array does
+template<class T>
+static bool readArray(const string& data, size_t& pos, vector<T>& v) {
+	unsigned int size = 0;
+	if (pos + sizeof(size) > data.size())
+		return false;
+	memcpy(&size, data.data() + pos, sizeof(size));
+	pos += sizeof(size);
+
+	if ((size_t)size * sizeof(T) > data.size() - pos)
+		return false;
+	v.resize(size);
+	if (size > 0)
+		memcpy(v.data(), data.data() + pos, size * sizeof(T));
+	pos += size * sizeof(T);
+	return true;
+}
+
+suffixArrayIndex::suffixArrayIndex(const string& s) : text(s) {
+	sa = buildSuffixArray(text);
+	lcp = buildLCPArray(text, sa);
+}
+
+//counts occurrences of p in the text
+//O(m log n) time, m = size of p
+int suffixArrayIndex::countOccurrences(const string& p) const {
+	if (p.empty())
+		return text.size();
+
+	// suffixes starting with p form a contiguous range of sa
+	int lo = 0;
+	int hi = sa.size();
+	while (lo < hi) {
+		int mid = (lo + hi) / 2;
+		if (text.compare(sa[mid], p.size(), p) < 0)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	int start = lo;
+
+	hi = sa.size();
+	while (lo < hi) {
+		int mid = (lo + hi) / 2;
+		if (text.compare(sa[mid], p.size(), p) <= 0)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	return lo - start;
+}
+
+//compact binary form of the index
+string suffixArrayIndex::serialize() const {
+	string out;
+	appendArray(out, vector<char>(text.begin(), text.end()));
+	appendArray(out, sa);
+	appendArray(out, lcp);
+	return out;
+}
+
+//rebuilds an index written by serialize, returns false if data is truncated or sa / lcp do not describe the text
+//sa is checked to be the sorted permutation of suffixes and lcp is recomputed, so a corrupt index is never accepted
+//O(n) time
+bool suffixArrayIndex::deserialize(const string& data, suffixArrayIndex& index) {
+	suffixArrayIndex result;
+	size_t pos = 0;
+	vector<char> chars;
+	if (!readArray(data, pos, chars) || !readArray(data, pos, result.sa) || !readArray(data, pos, result.lcp) || pos != data.size())
+		return false;
+	result.text.assign(chars.begin(), chars.end());
+
+	int n = result.text.size();
+	if (result.sa.size() != result.text.size() || result.lcp.size() != result.text.size())
+		return false;
+
+	// rank[i] is the position of suffix i in sa, -1 until seen, which also catches repeats
+	vector<int> rank(n + 1, -1);
+	for (int i = 0; i < n; i++) {
+		if (result.sa[i] < 0 || result.sa[i] >= n || rank[result.sa[i]] != -1)
+			return false;
+		rank[result.sa[i]] = i;
+	}
+
+	// consecutive suffixes are ordered if their first characters are, or those tie and the rest are already ordered
+	// the empty suffix (rank[n] = -1) sorts first
+	for (int i = 1; i < n; i++) {
+		int a = result.sa[i - 1];
+		int b = result.sa[i];
+		unsigned char ca = result.text[a];
+		unsigned char cb = result.text[b];
+		if (ca > cb || (ca == cb && rank[a + 1] > rank[b + 1]))
+			return false;
+	}
+
+	if (buildLCPArray(result.text, result.sa) != result.lcp)
+		return false;
+	index = result;
+	return true;
+}
+
+suffixAutomaton::suffixAutomaton() {
+	// state 0 is the initial state (empty string)
+	addState(0, -1, 0);
+	last = 0;
+}
+
+suffixAutomaton::suffixAutomaton(const string& s) : suffixAutomaton() {
+	len.reserve(2 * s.size() + 1);
+	link.reserve(2 * s.size() + 1);
+	for (size_t i = 0; i < s.size(); i++)
+		extend(s[i]);
+
+	// propagate end position counts up the suffix links, longest states first
+	int states = len.size();
+	vector<int> bucket(s.size() + 1, 0);
+	vector<int> order(states);
+	for (int i = 0; i < states; i++)
+		bucket[len[i]]++;
+	for (size_t i = 1; i < bucket.size(); i++)
+		bucket[i] += bucket[i - 1];
+	for (int i = states - 1; i >= 0; i--)
+		order[--bucket[len[i]]] = i;
+	for (int i = states - 1; i > 0; i--)
+		occ[link[order[i]]] += occ[order[i]];
+}
+
+// returns the edge leaving state on c, or -1
+// dense states look it up in their table, others scan fewer than denseEdges edges
+int suffixAutomaton::findEdge(int state, unsigned char c) const {
+	if (denseSlot[state] != -1)
+		return denseEdge[denseSlot[state] * 256 + c];
+	for (int e = firstEdge[state]; e != -1; e = edgeNext[e]) {
+		if (edgeChar[e] == c)
+			return e;
+	}
+	return -1;
+}
+
+// returns the state reached from state on c, or -1
+int suffixAutomaton::transition(int state, unsigned char c) const {
+	int e = findEdge(state, c);
+	return (e == -1) ? -1 : edgeTo[e];
+}
+
+// appends a state with no edges
+void suffixAutomaton::addState(int length, int suffixLink, int count) {
+	len.push_back(length);
+	link.push_back(suffixLink);
+	occ.push_back(count);
+	firstEdge.push_back(-1);
+	degree.push_back(0);
+	denseSlot.push_back(-1);
+}
+
+// adds an edge from state to to on c at the front of state's list, so it shadows any earlier edge on c
+void suffixAutomaton::addEdge(int state, int to, unsigned char c) {
+	edgeTo.push_back(to);
+	edgeChar.push_back(c);
+	edgeNext.push_back(firstEdge[state]);
+	firstEdge[state] = edgeTo.size() - 1;
+
+	if (denseSlot[state] != -1)
+		denseEdge[denseSlot[state] * 256 + c] = firstEdge[state];
+	else if (++degree[state] >= denseEdges)
+		makeDense(state);
+}
+
+// gives state a table from character to the first edge on it in state's list
+void suffixAutomaton::makeDense(int state) {
+	int slot = denseEdge.size() / 256;
+	denseEdge.resize(denseEdge.size() + 256, -1);
+	for (int e = firstEdge[state]; e != -1; e = edgeNext[e]) {
+		if (denseEdge[slot * 256 + edgeChar[e]] == -1)
+			denseEdge[slot * 256 + edgeChar[e]] = e;
+	}
+	denseSlot[state] = slot;
+}
+
+// adds character c to the end of the automaton's text
+void suffixAutomaton::extend(unsigned char c) {
+	int cur = len.size();
+	addState(len[last] + 1, -1, 1);
+
+	// add transitions on c until a state already has one
+	int p = last;
+	while (p != -1 && transition(p, c) == -1) {
+		addEdge(p, cur, c);
+		p = link[p];
+	}
+
+	if (p == -1)
+		link[cur] = 0;
+	else {
+		int q = transition(p, c);
+		if (len[p] + 1 == len[q])
+			link[cur] = q;
+		else {
+			// split q by cloning it with a shorter length
+			int clone = len.size();
+			addState(len[p] + 1, link[q], 0);
+			for (int e = firstEdge[q]; e != -1; e = edgeNext[e])
+				addEdge(clone, edgeTo[e], edgeChar[e]);
+
+			// redirect transitions to q onto the clone
+			while (p != -1) {
+				int e = findEdge(p, c);
+				if (e == -1 || edgeTo[e] != q)
+					break;
+				edgeTo[e] = clone;
+				p = link[p];
+			}
+			link[q] = clone;
+			link[cur] = clone;
+		}
+	}
+	last = cur;
+}
+
+//determines whether p is a substring of the text
+//O(m) time
+bool suffixAutomaton::contains(const string& p) const {
+	int state = 0;
+	for (size_t i = 0; i < p.size() && state != -1; i++)
+		state = transition(state, p[i]);
+	return state != -1;
+}
+
+//counts occurrences of p in the text
+//O(m) time
+int suffixAutomaton::countOccurrences(const string& p) const {
+	if (p.empty())
+		return len.size() > 1 ? len[last] : 0;
+
+	int state = 0;
+	for (size_t i = 0; i < p.size() && state != -1; i++)
+		state = transition(state, p[i]);
+	return (state == -1) ? 0 : occ[state];
+}
+
+//returns the length of the longest common substring of the text and t
+//O(m) time
+int suffixAutomaton::longestCommonSubstr(const string& t) const {
+	int state = 0;
+	int curLen = 0;
+	int best = 0;
+
+	for (size_t i = 0; i < t.size(); i++) {
+		// follow suffix links until the match can be extended by t[i]
+		while (state != 0 && transition(state, t[i]) == -1) {
+			state = link[state];
+			curLen = len[state];
+		}
+
+		int next = transition(state, t[i]);
+		if (next != -1) {
+			state = next;
+			curLen++;
+		}
+		best = max(best, curLen);
+	}
+	return best;
+}
+
+//counts the distinct non-empty substrings of the text
+//O(states) time
+long long suffixAutomaton::countDistinctSubstrings() const {
+	long long count = 0;
+	for (size_t i = 1; i < len.size(); i++)
+		count += len[i] - len[link[i]];
+	return count;
+}
+
+//compact binary form of the automaton
+string suffixAutomaton::serialize() const {
+	string out;
+	appendArray(out, len);
+	appendArray(out, link);
+	appendArray(out, occ);
+	appendArray(out, firstEdge);
+	appendArray(out, edgeTo);
+	appendArray(out, edgeNext);
+	appendArray(out, edgeChar);
+	out.append((const char*)&last, sizeof(last));
+	return out;
+}
+
+//rebuilds an automaton written by serialize, returns false if data is truncated or its links and edges are out of range
+//every suffix link must lead to a shorter state and every edge list must be a simple chain of in-range edges,
+//so walks over the result always terminate inside the arrays
+//the dense transition tables are not stored, they are rebuilt from the edge lists
+//O(states + edges) time
+bool suffixAutomaton::deserialize(const string& data, suffixAutomaton& sam) {
+	suffixAutomaton result;
+	size_t pos = 0;
+	if (!readArray(data, pos, result.len) || !readArray(data, pos, result.link) || !readArray(data, pos, result.occ) ||
+		!readArray(data, pos, result.firstEdge) || !readArray(data, pos, result.edgeTo) || !readArray(data, pos, result.edgeNext) ||
+		!readArray(data, pos, result.edgeChar))
+		return false;
+	if (pos + sizeof(result.last) != data.size())
+		return false;
+	memcpy(&result.last, data.data() + pos, sizeof(result.last));
+
+	int states = result.len.size();
+	int edges = result.edgeTo.size();
+	if (states == 0 || result.link.size() != result.len.size() || result.occ.size() != result.len.size() || result.firstEdge.size() != result.len.size())
+		return false;
+	if (result.edgeNext.size() != result.edgeTo.size() || result.edgeChar.size() != result.edgeTo.size())
+		return false;
+	if (result.last < 0 || result.last >= states || result.len[0] != 0 || result.link[0] != -1)
+		return false;
+
+	for (int i = 1; i < states; i++) {
+		int l = result.link[i];
+		if (l < 0 || l >= states || result.len[l] >= result.len[i])
+			return false;
+	}
+	for (int e = 0; e < edges; e++) {
+		if (result.edgeTo[e] < 0 || result.edgeTo[e] >= states || result.edgeNext[e] < -1 || result.edgeNext[e] >= edges)
+			return false;
+	}
+
+	// each edge may belong to one list only, which also rules out cycles
+	vector<char> used(edges, 0);
+	result.degree.assign(states, 0);
+	result.denseSlot.assign(states, -1);
+	result.denseEdge.clear();
+	for (int i = 0; i < states; i++) {
+		if (result.firstEdge[i] < -1 || result.firstEdge[i] >= edges)
+			return false;
+		for (int e = result.firstEdge[i]; e != -1; e = result.edgeNext[e]) {
+			if (used[e])
+				return false;
+			used[e] = 1;
+			result.degree[i]++;
+		}
+		if (result.degree[i] >= denseEdges)
+			result.makeDense(i);
+	}
+	sam = result;
+	return true;
+}
+
+//returns the length of the run of in[0] at the start of in (compares 32 bytes at a time with SSE2/AVX2)
+//O(run) time
+size_t runLength(const unsigned char* in, size_t size) {
+	if (size == 0)
+		return 0;
+
+	unsigned char value = in[0];
+	size_t i = 1;
+
+#if defined(__AVX2__)
+	__m256i target = _mm256_set1_epi8((char)value);
+	while (i + 32 <= size) {
+		__m256i block = _mm256_loadu_si256((const __m256i*)(in + i));
+		unsigned int mask = _mm256_movemask_epi8(_mm256_cmpeq_epi8(block, target));
+		if (mask != 0xFFFFFFFFu)
+			return i + __builtin_ctz(~mask);
+		i += 32;
+	}
+#elif defined(__SSE2__)
+	__m128i target = _mm_set1_epi8((char)value);
+	while (i + 32 <= size) {
+		__m128i lo = _mm_loadu_si128((const __m128i*)(in + i));
+		__m128i hi = _mm_loadu_si128((const __m128i*)(in + i + 16));
+		unsigned int mask = (unsigned int)_mm_movemask_epi8(_mm_cmpeq_epi8(lo, target))
+			| ((unsigned int)_mm_movemask_epi8(_mm_cmpeq_epi8(hi, target)) << 16);
+		if (mask != 0xFFFFFFFFu)
+			return i + __builtin_ctz(~mask);
+		i += 32;
+	}
+#endif
+
+	// finish the tail one byte at a time
+	while (i < size && in[i] == value)
+		i++;
+	return i;
+}
+
+// writes x as a little endian base-128 varint, returns bytes written
+static size_t writeVarint(unsigned long long x, unsigned char* out) {
+	size_t n = 0;
+	while (x >= 0x80) {
+		out[n++] = (unsigned char)(x | 0x80);
+		x >>= 7;
+	}
+	out[n++] = (unsigned char)x;
+	return n;
+}
+
+//largest output rleEncoder can produce for size input bytes (including its pending run)
+size_t rleEncodeBound(size_t size) {
+	// a run of length L takes 1 + varint(L) <= 2L bytes, plus one carried run of up to 11 bytes
+	return 2 * size + 11;
+}
+
+//encodes size bytes of in, out must hold rleEncodeBound(size) bytes, returns bytes written
+size_t rleEncoder::update(const unsigned char* in, size_t size, unsigned char* out) {
+	size_t written = 0;
+	size_t i = 0;
+
+	while (i < size) {
+		size_t run = runLength(in + i, size - i);
+
+		// extend the run carried over from the previous chunk
+		if (count > 0 && in[i] == value)
+			count += run;
+		else {
+			if (count > 0) {
+				out[written++] = value;
+				written += writeVarint(count, out + written);
+			}
+			value = in[i];
+			count = run;
+		}
+		i += run;
+	}
+	return written;
+}
+
+//writes the pending run (at most 11 bytes), returns bytes written
+size_t rleEncoder::finish(unsigned char* out) {
+	if (count == 0)
+		return 0;
+
+	out[0] = value;
+	size_t written = 1 + writeVarint(count, out + 1);
+	count = 0;
+	return written;
+}
+
+//decodes from in until out holds outCap bytes or in is used up
+//consumed is set to the number of input bytes used, returns bytes written
+size_t rleDecoder::update(const unsigned char* in, size_t size, size_t& consumed, unsigned char* out, size_t outCap) {
+	size_t i = 0;
+	size_t written = 0;
+
+	while (!failed) {
+		// flush as much of the current run as fits
+		if (remaining > 0) {
+			if (written == outCap)
+				break;
+			size_t n = min((unsigned long long)(outCap - written), remaining);
+			memset(out + written, value, n);
+			written += n;
+			remaining -= n;
+			continue;
+		}
+
+		if (i == size)
+			break;
+
+		// start a new run header
+		if (!inHeader) {
+			value = in[i++];
+			inHeader = true;
+			partial = 0;
+			shift = 0;
+			continue;
+		}
+
+		// read the next varint byte of the run length
+		unsigned char b = in[i++];
+		// the tenth byte only has room for bit 63, anything more would be silently dropped
+		if (shift == 63 && (b & 0x7E)) {
+			failed = true;
+			break;
+		}
+		partial |= (unsigned long long)(b & 0x7F) << shift;
+		shift += 7;
+		if (!(b & 0x80)) {
+			inHeader = false;
+			remaining = partial;
+			if (remaining == 0)
+				failed = true;
+		}
+		else if (shift >= 64)
+			failed = true;
+	}
+
+	consumed = i;
+	return written;
+}
+
+//determines whether the stream ended on a run boundary without errors
+bool rleDecoder::done() const {
+	return !failed && !inHeader && remaining == 0;
+}
+
+//binary-safe run length encoding, each run is stored as its byte followed by a varint count
+//O(n) time
+string rleEncode(const string& s) {
+	const size_t chunk = 1 << 16;
+	vector<unsigned char> buf(rleEncodeBound(chunk));
+	const unsigned char* in = (const unsigned char*)s.data();
+	rleEncoder enc;
+	string out;
+
+	// encode in fixed size chunks so output memory follows the compressed size
+	for (size_t pos = 0; pos < s.size(); pos += chunk) {
+		size_t n = enc.update(in + pos, min(chunk, s.size() - pos), buf.data());
+		out.append((const char*)buf.data(), n);
+	}
+	size_t n = enc.finish(buf.data());
+	out.append((const char*)buf.data(), n);
+	return out;
+}
+
+//decodes output of rleEncode into out, returns false on malformed input or if the output would exceed maxSize bytes
+//O(n) time
+bool rleDecode(const string& in, string& out, size_t maxSize) {
+	out.clear();
+	unsigned long long limit = min(maxSize, out.max_size());
+
+	// first pass sums run lengths so out is sized once
+	rleDecoder sizer;
+	unsigned long long total = 0;
+	size_t pos = 0;
+	while (pos < in.size()) {
+		size_t consumed = 0;
+		sizer.update((const unsigned char*)in.data() + pos, in.size() - pos, consumed, nullptr, 0);
+		pos += consumed;
+		if (sizer.failed || consumed == 0)
+			return false;
+		if (!sizer.inHeader) {
+			// checked as a difference so the sum cannot wrap
+			if (sizer.remaining > limit - total)
+				return false;
+			total += sizer.remaining;
+			sizer.remaining = 0;
+		}
+	}
+	if (!sizer.done())
+		return false;
+
+	out.resize(total);
+	rleDecoder dec;
+	size_t consumed = 0;
+	dec.update((const unsigned char*)in.data(), in.size(), consumed, (unsigned char*)&out[0], total);
+	return dec.done();
+}
+
+//reverses size bytes starting at str in place (16 bytes at a time with SSSE3)
+//O(n) time
+void reverseBytes(char* str, size_t size) {
+	char* lo = str;
+	char* hi = str + size;
+
+#if defined(__SSSE3__)
+	// swap 16-byte blocks from both ends, reversing each with a shuffle
+	const __m128i reversed = _mm_setr_epi8(15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0);
+	while (hi - lo >= 32) {
+		hi -= 16;
+		__m128i a = _mm_loadu_si128((const __m128i*)lo);
+		__m128i b = _mm_loadu_si128((const __m128i*)hi);
+		_mm_storeu_si128((__m128i*)lo, _mm_shuffle_epi8(b, reversed));
+		_mm_storeu_si128((__m128i*)hi, _mm_shuffle_epi8(a, reversed));
+		lo += 16;
+	}
+#elif defined(__GNUC__)
+	// swap 8-byte words from both ends, reversing each with a byte swap
+	while (hi - lo >= 16) {
+		hi -= 8;
+		unsigned long long a, b;
+		memcpy(&a, lo, 8);
+		memcpy(&b, hi, 8);
+		a = __builtin_bswap64(a);
+		b = __builtin_bswap64(b);
+		memcpy(lo, &b, 8);
+		memcpy(hi, &a, 8);
+		lo += 8;
+	}
+#endif
+
+	// swap remaining middle bytes
+	while (hi - lo > 1) {
+		hi--;
+		char tmp = *lo;
+		*lo++ = *hi;
+		*hi = tmp;
+	}
+}
+
+#if defined(__SSE2__)
+// bitmask of the space bytes among the 16 bytes at p
+static unsigned int spaceMask(const char* p) {
+	__m128i x = _mm_loadu_si128((const __m128i*)p);
+	return _mm_movemask_epi8(_mm_cmpeq_epi8(x, _mm_set1_epi8(' ')));
+}
+#endif
+
+// returns the index of the first byte at or after i that is a space (if space) or not a space (if !space)
+static size_t findSpaceBoundary(const char* str, size_t i, size_t size, bool space) {
+#if defined(__SSE2__)
+	while (i + 16 <= size) {
+		unsigned int mask = spaceMask(str + i);
+		if (!space)
+			mask = ~mask & 0xFFFF;
+		if (mask != 0)
+			return i + __builtin_ctz(mask);
+		i += 16;
+	}
+#endif
+	while (i < size && (str[i] == ' ') != space)
+		i++;
+	return i;
+}
+
+//reverses the order of space separated words in the first size bytes of str in place
+//word boundaries are found 16 bytes at a time with SSE2
+//O(n) time
+void reverseWords(char* str, size_t size) {
+	// reverse whole string, then put each word's characters back in order
+	reverseBytes(str, size);
+
+	size_t i = 0;
+	while (i < size) {
+		size_t wordBegin = findSpaceBoundary(str, i, size, false);
+		size_t wordEnd = findSpaceBoundary(str, wordBegin, size, true);
+		reverseBytes(str + wordBegin, wordEnd - wordBegin);
+		i = wordEnd;
+	}
+}
+
+#if defined(__SSSE3__)
+namespace {
+
+// shuffle patterns that pack the kept bytes of an 8-byte group to the front, indexed by its space mask
+struct compactPatterns
+{
+	unsigned char pattern[256][8];
+
+	compactPatterns() {
+		for (int mask = 0; mask < 256; mask++) {
+			int k = 0;
+			for (int b = 0; b < 8; b++) {
+				if (!(mask & (1 << b)))
+					pattern[mask][k++] = b;
+			}
+			// 0x80 makes pshufb write a zero byte
+			while (k < 8)
+				pattern[mask][k++] = 0x80;
+		}
+	}
+};
+
+}
+#endif
+
+//removes spaces from the first size bytes of str in place and returns the new size
+//packs 16 bytes at a time with SSSE3 shuffles
+//O(n) time
+size_t removeSpaces(char* str, size_t size) {
+	size_t out = 0;
+	size_t i = 0;
+
+#if defined(__SSSE3__)
+	static const compactPatterns table;
+
+	// output never passes the block being read, so stores can't clobber unread input
+	while (i + 16 <= size) {
+		unsigned int mask = spaceMask(str + i);
+		__m128i x = _mm_loadu_si128((const __m128i*)(str + i));
+		if (mask == 0)
+			_mm_storeu_si128((__m128i*)(str + out), x);
+		else if (mask != 0xFFFF) {
+			unsigned int lowMask = mask & 0xFF;
+			unsigned int highMask = mask >> 8;
+			__m128i low = _mm_loadl_epi64((const __m128i*)table.pattern[lowMask]);
+			__m128i high = _mm_loadl_epi64((const __m128i*)table.pattern[highMask]);
+			_mm_storel_epi64((__m128i*)(str + out), _mm_shuffle_epi8(x, low));
+			out += 8 - __builtin_popcount(lowMask);
+			_mm_storel_epi64((__m128i*)(str + out), _mm_shuffle_epi8(_mm_srli_si128(x, 8), high));
+			out += 8 - __builtin_popcount(highMask);
+			i += 16;
+			continue;
+		}
+		out += 16 - __builtin_popcount(mask);
+		i += 16;
+	}
+#elif defined(__SSE2__)
+	// skip the per-byte loop for blocks with no spaces
+	while (i + 16 <= size) {
+		unsigned int mask = spaceMask(str + i);
+		if (mask == 0) {
+			memmove(str + out, str + i, 16);
+			out += 16;
+		}
+		else {
+			for (size_t j = i; j < i + 16; j++) {
+				if (str[j] != ' ')
+					str[out++] = str[j];
+			}
+		}
+		i += 16;
+	}
+#endif
+
+	for (; i < size; i++) {
+		if (str[i] != ' ')
+			str[out++] = str[i];
+	}
+	return out;
+}
+
+//computes palindrome radii of the first n bytes of s (Manacher's algorithm)
+//d1[i] = number of odd length palindromes centered at i
+//d2[i] = number of even length palindromes centered between i-1 and i
+//O(n) time, O(n) space
+void manacher(const char* s, size_t n, vector<int>& d1, vector<int>& d2) {
+	d1.assign(n, 0);
+	d2.assign(n, 0);
+
+	// [l, r] is the rightmost palindrome found so far, centers inside it start from their mirror
+	int l = 0;
+	int r = -1;
+	for (int i = 0; i < (int)n; i++) {
+		int k = (i > r) ? 1 : min(d1[l + r - i], r - i + 1);
+		while (i - k >= 0 && i + k < (int)n && s[i - k] == s[i + k])
+			k++;
+		d1[i] = k;
+		if (i + k - 1 > r) {
+			l = i - k + 1;
+			r = i + k - 1;
+		}
+	}
+
+	l = 0;
+	r = -1;
+	for (int i = 0; i < (int)n; i++) {
+		int k = (i > r) ? 0 : min(d2[l + r - i + 1], r - i + 1);
+		while (i - k - 1 >= 0 && i + k < (int)n && s[i - k - 1] == s[i + k])
+			k++;
+		d2[i] = k;
+		if (i + k - 1 > r) {
+			l = i - k;
+			r = i + k - 1;
+		}
+	}
+}
+
+//returns the longest palindromic substring of s
+//O(n) time
+string longestPalindromicSubstr(const string& s) {
+	vector<int> d1, d2;
+	int n = s.size();
+	manacher(s.data(), n, d1, d2);
+
+	int bestStart = 0;
+	int bestLen = 0;
+	for (int i = 0; i < n; i++) {
+		if (2 * d1[i] - 1 > bestLen) {
+			bestLen = 2 * d1[i] - 1;
+			bestStart = i - d1[i] + 1;
+		}
+		if (2 * d2[i] > bestLen) {
+			bestLen = 2 * d2[i];
+			bestStart = i - d2[i];
+		}
+	}
+	return s.substr(bestStart, bestLen);
+}
+
+//counts the palindromic substrings of s (each occurrence counted separately)
+//O(n) time
+long long countPalindromicSubstrings(const string& s) {
+	vector<int> d1, d2;
+	int n = s.size();
+	manacher(s.data(), n, d1, d2);
+
+	// every radius up to the maximal one is a palindrome
+	long long count = 0;
+	for (int i = 0; i < n; i++)
+		count += d1[i] + d2[i];
+	return count;
+}
+
+//returns the maximal palindrome around every center of s as (start, length) pairs
+//odd centers come first, then even centers, empty palindromes are skipped
+//O(n) time
+vector<pair<int, int>> maximalPalindromes(const string& s) {
+	vector<int> d1, d2;
+	int n = s.size();
+	manacher(s.data(), n, d1, d2);
+
+	vector<pair<int, int>> res;
+	res.reserve(2 * n);
+	for (int i = 0; i < n; i++)
+		res.push_back(make_pair(i - d1[i] + 1, 2 * d1[i] - 1));
+	for (int i = 0; i < n; i++) {
+		if (d2[i] > 0)
+			res.push_back(make_pair(i - d2[i], 2 * d2[i]));
+	}
+	return res;
+}
+
+palindromicTree::palindromicTree() {
+	// node 0 is the imaginary root of length -1, node 1 is the empty palindrome
+	len.push_back(-1);
+	link.push_back(0);
+	depth.push_back(0);
+	firstEdge.push_back(-1);
+
+	len.push_back(0);
+	link.push_back(0);
+	depth.push_back(0);
+	firstEdge.push_back(-1);
+	last = 1;
+}
+
+// returns the child of node along c, or -1
+int palindromicTree::transition(int node, unsigned char c) const {
+	for (int e = firstEdge[node]; e != -1; e = edgeNext[e]) {
+		if (edgeChar[e] == c)
+			return edgeTo[e];
+	}
+	return -1;
+}
+
+// follows suffix links from node until its palindrome can be wrapped by text[pos]
+int palindromicTree::findSuffix(int node, int pos) const {
+	while (true) {
+		int before = pos - len[node] - 1;
+		if (before >= 0 && text[before] == text[pos])
+			return node;
+		node = link[node];
+	}
+}
+
+//appends c to the text, returns whether it created a new distinct palindrome
+//O(1) amortized time
+bool palindromicTree::add(char c) {
+	text += c;
+	int pos = text.size() - 1;
+	int parent = findSuffix(last, pos);
+
+	int existing = transition(parent, c);
+	if (existing != -1) {
+		last = existing;
+		total += depth[last];
+		return false;
+	}
+
+	// new palindrome c + parent + c
+	int node = len.size();
+	len.push_back(len[parent] + 2);
+	firstEdge.push_back(-1);
+	if (len[node] == 1)
+		link.push_back(1);
+	else
+		link.push_back(transition(findSuffix(link[parent], pos), c));
+	depth.push_back(depth[link[node]] + 1);
+
+	edgeTo.push_back(node);
+	edgeChar.push_back(c);
+	edgeNext.push_back(firstEdge[parent]);
+	firstEdge[parent] = edgeTo.size() - 1;
+
+	last = node;
+	total += depth[last];
+	return true;
+}
+
+//number of distinct non-empty palindromes in the text
+int palindromicTree::distinctPalindromes() const {
+	return len.size() - 2;
+}
+
+//number of palindromic substrings in the text (each occurrence counted separately)
+long long palindromicTree::palindromeCount() const {
+	return total;
+}
+
+//length of the longest palindrome ending at the last character
+int palindromicTree::longestSuffixPalindrome() const {
+	return len[last];
+}
+
+// shared body of the in-place nextPermutation overloads
+template<class T>
+bool nextPermutationHelper(T arr[], int size) {
+	// find beginning of latest suffix (sequence of non-increasing values)
+	int suffix = size - 1;
+	while (suffix > 0 && arr[suffix] <= arr[suffix - 1])
+		suffix--;
+
+	// last permutation so wrap around to the first one
+	if (suffix <= 0) {
+		reverse(arr, arr + size);
+		return false;
+	}
+
+	// swap pivot (suffix-1) with the smallest greater value in the suffix
+	int i = size - 1;
+	while (arr[i] <= arr[suffix - 1])
+		i--;
+	std::swap(arr[i], arr[suffix - 1]);
+
+	// suffix is non-increasing so reversing it makes it the smallest arrangement
+	reverse(arr + suffix, arr + size);
+	return true;
+}
+
+//rearranges arr into the next lexicographically greater permutation in place
+//returns false and leaves arr sorted ascending if arr was the last permutation
+//repeated values are fine, so looping from sorted order visits each multiset permutation once
+//O(n) time
+bool nextPermutation(int arr[], int size) {
+	return nextPermutationHelper(arr, size);
+}
+
+bool nextPermutation(char str[], int size) {
+	return nextPermutationHelper(str, size);
+}
+
+//rearranges the k-subset comb of {0, ..., n-1} (kept ascending) into the next one in lexicographic order
+//returns false after the last subset
+//O(k) time
+bool nextCombination(int comb[], int k, int n) {
+	// find rightmost element that can still move right
+	int i = k - 1;
+	while (i >= 0 && comb[i] == n - k + i)
+		i--;
+	if (i < 0)
+		return false;
+
+	// bump it and pack the following elements right after it
+	comb[i]++;
+	for (int j = i + 1; j < k; j++)
+		comb[j] = comb[j - 1] + 1;
+	return true;
+}
+
+heapPermuter::heapPermuter(int arr[], int size) : arr(arr), size(size), counters(size, 0) {}
+
+//advances arr to the next permutation, returns false once all have been produced
+bool heapPermuter::next() {
+	// iterative Heap's algorithm, counters[i] plays the role of the loop index at recursion depth i
+	while (i < size) {
+		if (counters[i] < i) {
+			if (i % 2 == 0)
+				std::swap(arr[0], arr[i]);
+			else
+				std::swap(arr[counters[i]], arr[i]);
+			counters[i]++;
+			i = 1;
+			return true;
+		}
+		counters[i] = 0;
+		i++;
+	}
+	done = true;
+	return false;
+}
+
+//copies up to maxCount successive permutations (starting with the current one) into out
+//out must hold maxCount * size ints, returns the number copied
+int heapPermuter::nextBatch(int out[], int maxCount) {
+	if (done)
+		return 0;
+
+	int count = 0;
+	while (count < maxCount) {
+		copy(arr, arr + size, out + (long long)count * size);
+		count++;
+		if (!next())
+			break;
+	}
+	return count;
+}
+
+//calls visit on every permutation of arr, generated in place with Heap's algorithm
+//each step is a single swap, stops early if visit returns false
+//O(n!) time, O(n) space
+void heapPermutations(int arr[], int size, const function<bool(const int*, int)>& visit) {
+	heapPermuter perms(arr, size);
+	do {
+		if (!visit(arr, size))
+			return;
+	} while (perms.next());
+}
+
+//returns the lexicographic rank of a permutation of {0, ..., size-1} (Lehmer code), size <= 20
+//O(n^2) time
+unsigned long long permutationRank(const int arr[], int size) {
+	unsigned long long rank = 0;
+	for (int i = 0; i < size; i++) {
+		// digit i of the Lehmer code counts smaller values to the right
+		int smaller = 0;
+		for (int j = i + 1; j < size; j++) {
+			if (arr[j] < arr[i])
+				smaller++;
+		}
+		rank = rank * (size - i) + smaller;
+	}
+	return rank;
+}
+
+//writes the permutation of {0, ..., size-1} with the given lexicographic rank into arr, size <= 20
+//O(n^2) time
+void permutationUnrank(unsigned long long rank, int arr[], int size) {
+	// decode factorial base digits from the least significant end
+	for (int i = size - 1; i >= 0; i--) {
+		arr[i] = rank % (size - i);
+		rank /= (size - i);
+	}
+
+	// turn Lehmer digits into values by bumping everything at or above each later pick
+	for (int i = size - 1; i >= 0; i--) {
+		for (int j = i + 1; j < size; j++) {
+			if (arr[j] >= arr[i])
+				arr[j]++;
+		}
+	}
+}
+
+//calls visit on count permutations of {0, ..., size-1} in lexicographic order starting at rank first
+//splits the permutation space into independent ranges for parallel workers
+//O(n^2 + count * n) time
+void permutationRange(unsigned long long first, unsigned long long count, int size, const function<bool(const int*, int)>& visit) {
+	if (count == 0)
+		return;
+
+	vector<int> perm(size);
+	permutationUnrank(first, perm.data(), size);
+	for (unsigned long long k = 0; k < count; k++) {
+		if (!visit(perm.data(), size))
+			return;
+		if (!nextPermutation(perm.data(), size))
+			return;
+	}
+}
+
+//counts the distinct permutations of arr (multinomial coefficient), saturates at ULLONG_MAX
+//O(n log n) time
+unsigned long long countMultisetPermutations(const int arr[], int size) {
+	vector<int> sorted(arr, arr + size);
+	sort(sorted.begin(), sorted.end());
+
+	// multiply in n! / (c1! c2! ...) one factor at a time, i-th copy of a value divides by i
+	unsigned long long count = 1;
+	int run = 0;
+	for (int i = 0; i < size; i++) {
+		run = (i > 0 && sorted[i] == sorted[i - 1]) ? run + 1 : 1;
+
+		// count * (i+1) / run stays integral because it is a product of binomials
+		unsigned long long g = count;
+		unsigned long long r = run;
+		while (r != 0) {
+			unsigned long long t = g % r;
+			g = r;
+			r = t;
+		}
+		unsigned long long num = count / g;
+		unsigned long long den = run / g;
+		unsigned long long factor = (i + 1) / den;
+		if (num > ULLONG_MAX / factor)
+			return ULLONG_MAX;
+		count = num * factor;
+	}
+	return count;
+}
+
+// number of the first count keys (padded with INT_MAX) that are below key, compares 16 keys with SSE2
+static int keysBelow(const int keys[], int count, int key) {
+#if defined(__SSE2__)
+	__m128i k = _mm_set1_epi32(key);
+	unsigned int mask = 0;
+	for (int i = 0; i < bPlusTree::nodeKeys; i += 4) {
+		__m128i block = _mm_loadu_si128((const __m128i*)(keys + i));
+		mask |= (unsigned int)_mm_movemask_ps(_mm_castsi128_ps(_mm_cmplt_epi32(block, k))) << i;
+	}
+	return min(__builtin_popcount(mask), count);
+#else
+	int i = 0;
+	while (i < count && keys[i] < key)
+		i++;
+	return i;
+#endif
+}
+
+// child of an inner node to follow for key, separator keys[i] is the smallest key under children[i+1]
+static int childIndex(const int keys[], int count, int key) {
+	if (key == INT_MAX)
+		return count;
+	return keysBelow(keys, count, key + 1);
+}
+
+int bPlusTree::iterator::key() const {
+	return leaf->keys[pos];
+}
+
+int bPlusTree::iterator::value() const {
+	return leaf->values[pos];
+}
+
+//moves to the next entry in key order
+void bPlusTree::iterator::next() {
+	pos++;
+	// skip to the next non-empty leaf
+	while (leaf != nullptr && pos >= leaf->count) {
+		leaf = leaf->next;
+		pos = 0;
+	}
+}
+
+bPlusTree::bPlusTree() : height(0), count(0) {
+	leafNode* leaf = new leafNode();
+	fill(leaf->keys, leaf->keys + nodeKeys, INT_MAX);
+	leaf->count = 0;
+	leaf->next = nullptr;
+	root = leaf;
+}
+
+bPlusTree::~bPlusTree() {
+	destroy(root, height);
+}
+
+// frees node and its subtree, level 0 is a leaf
+void bPlusTree::destroy(void* node, int level) {
+	if (level == 0) {
+		delete (leafNode*)node;
+		return;
+	}
+	innerNode* inner = (innerNode*)node;
+	for (int i = 0; i <= inner->count; i++)
+		destroy(inner->children[i], level - 1);
+	delete inner;
+}
+
+// descends to the leaf that would hold key
+const bPlusTree::leafNode* bPlusTree::findLeaf(int key) const {
+	void* node = root;
+	for (int level = height; level > 0; level--) {
+		const innerNode* inner = (const innerNode*)node;
+		node = inner->children[childIndex(inner->keys, inner->count, key)];
+	}
+	return (const leafNode*)node;
+}
+
+//looks up key, returns false if it is missing
+//O(log n) time
+bool bPlusTree::find(int key, int& value) const {
+	const leafNode* leaf = findLeaf(key);
+	int i = keysBelow(leaf->keys, leaf->count, key);
+	if (i < leaf->count && leaf->keys[i] == key) {
+		value = leaf->values[i];
+		return true;
+	}
+	return false;
+}
+
+//first entry with key >= key
+//O(log n) time
+bPlusTree::iterator bPlusTree::lowerBound(int key) const {
+	const leafNode* leaf = findLeaf(key);
+	iterator it = { leaf, keysBelow(leaf->keys, leaf->count, key) };
+	if (it.pos >= leaf->count) {
+		it.pos--;
+		it.next();
+	}
+	return it;
+}
+
+//first entry of the tree
+bPlusTree::iterator bPlusTree::begin() const {
+	return lowerBound(INT_MIN);
+}
+
+// inserts into the subtree at node, reports a split through splitKey/splitNode, returns whether key was new
+bool bPlusTree::insertAt(void* node, int level, int key, int value, int& splitKey, void*& splitNode) {
+	splitNode = nullptr;
+
+	if (level == 0) {
+		leafNode* leaf = (leafNode*)node;
+		int i = keysBelow(leaf->keys, leaf->count, key);
+		if (i < leaf->count && leaf->keys[i] == key) {
+			leaf->values[i] = value;
+			return false;
+		}
+
+		// full leaf: move the upper half to a new right sibling first
+		if (leaf->count == nodeKeys) {
+			leafNode* right = new leafNode();
+			fill(right->keys, right->keys + nodeKeys, INT_MAX);
+			int half = nodeKeys / 2;
+			right->count = nodeKeys - half;
+			copy(leaf->keys + half, leaf->keys + nodeKeys, right->keys);
+			copy(leaf->values + half, leaf->values + nodeKeys, right->values);
+			fill(leaf->keys + half, leaf->keys + nodeKeys, INT_MAX);
+			leaf->count = half;
+			right->next = leaf->next;
+			leaf->next = right;
+			splitKey = right->keys[0];
+			splitNode = right;
+			if (i > half) {
+				leaf = right;
+				i -= half;
+			}
+			else if (i == half && key >= splitKey) {
+				leaf = right;
+				i = 0;
+			}
+		}
+
+		for (int j = leaf->count; j > i; j--) {
+			leaf->keys[j] = leaf->keys[j - 1];
+			leaf->values[j] = leaf->values[j - 1];
+		}
+		leaf->keys[i] = key;
+		leaf->values[i] = value;
+		leaf->count++;
+		if (splitNode != nullptr)
+			splitKey = ((leafNode*)splitNode)->keys[0];
+		return true;
+	}
+
+	innerNode* inner = (innerNode*)node;
+	int i = childIndex(inner->keys, inner->count, key);
+	int childKey;
+	void* childSplit;
+	bool added = insertAt(inner->children[i], level - 1, key, value, childKey, childSplit);
+	if (childSplit == nullptr)
+		return added;
+
+	// place the child's new sibling right after it
+	int keys[nodeKeys + 1];
+	void* children[nodeKeys + 2];
+	copy(inner->keys, inner->keys + inner->count, keys);
+	copy(inner->children, inner->children + inner->count + 1, children);
+	for (int j = inner->count; j > i; j--) {
+		keys[j] = keys[j - 1];
+		children[j + 1] = children[j];
+	}
+	keys[i] = childKey;
+	children[i + 1] = childSplit;
+	int total = inner->count + 1;
+
+	if (total <= nodeKeys) {
+		copy(keys, keys + total, inner->keys);
+		copy(children, children + total + 1, inner->children);
+		inner->count = total;
+		return added;
+	}
+
+	// split the inner node, the middle key moves up
+	int half = total / 2;
+	innerNode* right = new innerNode();
+	fill(right->keys, right->keys + nodeKeys, INT_MAX);
+	fill(inner->keys, inner->keys + nodeKeys, INT_MAX);
+	copy(keys, keys + half, inner->keys);
+	copy(children, children + half + 1, inner->children);
+	inner->count = half;
+	right->count = total - half - 1;
+	copy(keys + half + 1, keys + total, right->keys);
+	copy(children + half + 1, children + total + 1, right->children);
+	splitKey = keys[half];
+	splitNode = right;
+	return added;
+}
+
+//inserts key or overwrites its value
+//O(log n) time
+void bPlusTree::insert(int key, int value) {
+	int splitKey;
+	void* splitNode;
+	if (insertAt(root, height, key, value, splitKey, splitNode))
+		count++;
+
+	// root split grows the tree by one level
+	if (splitNode != nullptr) {
+		innerNode* newRoot = new innerNode();
+		fill(newRoot->keys, newRoot->keys + nodeKeys, INT_MAX);
+		newRoot->keys[0] = splitKey;
+		newRoot->children[0] = root;
+		newRoot->children[1] = splitNode;
+		newRoot->count = 1;
+		root = newRoot;
+		height++;
+	}
+}
+
+//removes key, returns false if it was not present
+//O(log n) time
+bool bPlusTree::erase(int key) {
+	leafNode* leaf = (leafNode*)findLeaf(key);
+	int i = keysBelow(leaf->keys, leaf->count, key);
+	if (i >= leaf->count || leaf->keys[i] != key)
+		return false;
+
+	for (int j = i; j + 1 < leaf->count; j++) {
+		leaf->keys[j] = leaf->keys[j + 1];
+		leaf->values[j] = leaf->values[j + 1];
+	}
+	leaf->count--;
+	leaf->keys[leaf->count] = INT_MAX;
+	count--;
+	return true;
+}
+
+//calls visit(key, value) on every entry with lo <= key < hi
+//O(log n + k) time
+void bPlusTree::forEachInRange(int lo, int hi, const function<void(int, int)>& visit) const {
+	for (iterator it = lowerBound(lo); it.valid() && it.key() < hi; it.next())
+		visit(it.key(), it.value());
+}
+
+//replaces the contents with strictly increasing keys and their values, filling nodes completely
+//O(n) time
+void bPlusTree::bulkLoad(const vector<int>& keys, const vector<int>& values) {
+	destroy(root, height);
+	height = 0;
+	count = keys.size();
+
+	// fill leaves left to right and link them
+	vector<void*> level;
+	vector<int> firstKeys;
+	leafNode* prev = nullptr;
+	for (size_t start = 0; start < keys.size() || level.empty(); start += nodeKeys) {
+		leafNode* leaf = new leafNode();
+		fill(leaf->keys, leaf->keys + nodeKeys, INT_MAX);
+		leaf->count = min((size_t)nodeKeys, keys.size() - start);
+		copy(keys.begin() + start, keys.begin() + start + leaf->count, leaf->keys);
+		copy(values.begin() + start, values.begin() + start + leaf->count, leaf->values);
+		leaf->next = nullptr;
+		if (prev)
+			prev->next = leaf;
+		prev = leaf;
+		level.push_back(leaf);
+		firstKeys.push_back(leaf->count > 0 ? leaf->keys[0] : INT_MIN);
+	}
+
+	// build inner levels until a single root remains
+	while (level.size() > 1) {
+		vector<void*> parents;
+		vector<int> parentFirst;
+		size_t start = 0;
+		while (start < level.size()) {
+			size_t end = min(level.size(), start + nodeKeys + 1);
+			// keep at least two children in the last node so separators stay meaningful
+			if (level.size() - end == 1)
+				end--;
+			innerNode* inner = new innerNode();
+			fill(inner->keys, inner->keys + nodeKeys, INT_MAX);
+			inner->count = end - start - 1;
+			for (size_t i = start; i < end; i++) {
+				inner->children[i - start] = level[i];
+				if (i > start)
+					inner->keys[i - start - 1] = firstKeys[i];
+			}
+			parents.push_back(inner);
+			parentFirst.push_back(firstKeys[start]);
+			start = end;
+		}
+		level.swap(parents);
+		firstKeys.swap(parentFirst);
+		height++;
+	}
+	root = level[0];
+}
+
+//calls visit(key, valueA, valueB) for each key present in both trees, merging their leaf chains
+//whole leaves that end below the other side's current key are skipped
+//O(n + m) time worst case
+void mergeJoin(const bPlusTree& a, const bPlusTree& b, const function<void(int, int, int)>& visit) {
+	bPlusTree::iterator i = a.begin();
+	bPlusTree::iterator j = b.begin();
+
+	while (i.valid() && j.valid()) {
+		// jump over leaves whose last key is still too small
+		if (i.leaf->keys[i.leaf->count - 1] < j.key()) {
+			i.pos = i.leaf->count - 1;
+			i.next();
+			continue;
+		}
+		if (j.leaf->keys[j.leaf->count - 1] < i.key()) {
+			j.pos = j.leaf->count - 1;
+			j.next();
+			continue;
+		}
+
+		if (i.key() < j.key())
+			i.next();
+		else if (j.key() < i.key())
+			j.next();
+		else {
+			visit(i.key(), i.value(), j.value());
+			i.next();
+			j.next();
+		}
+	}
+}
+
+//calls visit(key, value) for each element of the sorted array keys[0...size-1] present in the tree
+//O(n + m) time worst case
+void mergeJoin(const bPlusTree& a, const int keys[], int size, const function<void(int, int)>& visit) {
+	bPlusTree::iterator i = a.begin();
+	int j = 0;
+
+	while (i.valid() && j < size) {
+		// jump over leaves that end before the next array key
+		if (i.leaf->keys[i.leaf->count - 1] < keys[j]) {
+			i.pos = i.leaf->count - 1;
+			i.next();
+			continue;
+		}
+
+		if (i.key() < keys[j])
+			i.next();
+		else if (keys[j] < i.key())
+			j++;
+		else {
+			visit(i.key(), i.value());
+			i.next();
+			j++;
+		}
+	}
+}
+
+//clears every bit
+//O(n / 64) time
+void vertexBitset::clear() {
+	for (size_t i = 0; i < words.size(); i++)
+		words[i].store(0, memory_order_relaxed);
+}
+
+//number of set bits
+//O(n / 64) time
+size_t vertexBitset::count() const {
+	size_t total = 0;
+	for (size_t i = 0; i < words.size(); i++)
+		total += __builtin_popcountll(words[i].load(memory_order_relaxed));
+	return total;
+}
+
+csrGraph::csrGraph(const csrGraph& other)
+	: offsets(other.offsets), targets(other.targets), weights(other.weights),
+	offsetData(other.offsetData), targetData(other.targetData), weightData(other.weightData),
+	n(other.n), m(other.m), mapping(other.mapping) {
+	// owned arrays were copied, so point at the copies; mapped views share the mapping
+	if (!mapping)
+		bind();
+}
+
+csrGraph& csrGraph::operator=(const csrGraph& other) {
+	if (this != &other) {
+		csrGraph copy(other);
+		*this = move(copy);
+	}
+	return *this;
+}
+
+csrGraph::csrGraph(csrGraph&& other) : csrGraph() {
+	*this = move(other);
+}
+
+csrGraph& csrGraph::operator=(csrGraph&& other) {
+	if (this != &other) {
+		offsets = move(other.offsets);
+		targets = move(other.targets);
+		weights = move(other.weights);
+		offsetData = other.offsetData;
+		targetData = other.targetData;
+		weightData = other.weightData;
+		n = other.n;
+		m = other.m;
+		mapping = move(other.mapping);
+		if (!mapping)
+			bind();
+		// the source must not keep pointing into arrays it no longer owns
+		other.reset();
+	}
+	return *this;
+}
+
+//drops the arrays (or mapping), leaving an empty graph
+void csrGraph::reset() {
+	offsets.assign(1, 0);
+	targets.clear();
+	weights.clear();
+	bind();
+}
+
+//points the accessors at the owned vectors
+void csrGraph::bind() {
+	offsetData = offsets.data();
+	targetData = targets.data();
+	weightData = weights.empty() ? nullptr : weights.data();
+	n = (uint32_t)(offsets.size() - 1);
+	m = targets.size();
+	mapping.reset();
+}
+
+//builds a graph with n vertices from (from, to) edges, both directions are stored if undirected
+//counting sort by source, then each neighbor list is sorted in place (lists are short, so this beats a second scatter pass)
+//O(n + m log d) time, d = maximum degree
+csrGraph csrGraph::fromEdges(uint32_t n, const vector<pair<uint32_t, uint32_t>>& edges, bool undirected) {
+	csrGraph g;
+	g.offsets.assign((size_t)n + 1, 0);
+	for (size_t i = 0; i < edges.size(); i++) {
+		g.offsets[edges[i].first + 1]++;
+		if (undirected)
+			g.offsets[edges[i].second + 1]++;
+	}
+	for (uint32_t v = 0; v < n; v++)
+		g.offsets[v + 1] += g.offsets[v];
+
+	g.targets.resize(g.offsets[n]);
+	vector<uint64_t> fill(g.offsets.begin(), g.offsets.end() - 1);
+	for (size_t i = 0; i < edges.size(); i++) {
+		g.targets[fill[edges[i].first]++] = edges[i].second;
+		if (undirected)
+			g.targets[fill[edges[i].second]++] = edges[i].first;
+	}
+
+	for (uint32_t v = 0; v < n; v++)
+		sort(g.targets.begin() + g.offsets[v], g.targets.begin() + g.offsets[v + 1]);
+	g.bind();
+	return g;
+}
+
+//determines whether the edge (from, to) exists
+//O(log d) time
+bool csrGraph::hasEdge(uint32_t from, uint32_t to) const {
+	return binary_search(neighborsBegin(from), neighborsEnd(from), to);
+}
+
+//graph with every edge reversed
+//sources are visited in increasing order, so the reversed lists come out sorted without a sort pass
+//O(n + m) time
+csrGraph csrGraph::transpose() const {
+	uint32_t n = vertexCount();
+	csrGraph t;
+	t.offsets.assign((size_t)n + 1, 0);
+	for (uint64_t e = 0; e < edgeCount(); e++)
+		t.offsets[targetData[e] + 1]++;
+	for (uint32_t v = 0; v < n; v++)
+		t.offsets[v + 1] += t.offsets[v];
+
+	t.targets.resize(edgeCount());
+	t.weights.resize(weightData ? edgeCount() : 0);
+	vector<uint64_t> fill(t.offsets.begin(), t.offsets.end() - 1);
+	for (uint32_t v = 0; v < n; v++) {
+		for (uint64_t e = offsetData[v]; e < offsetData[v + 1]; e++) {
+			uint64_t slot = fill[targetData[e]]++;
+			t.targets[slot] = v;
+			if (weightData)
+				t.weights[slot] = weightData[e];
+		}
+	}
+	t.bind();
+	return t;
+}
+
+//builds a weighted graph with n vertices, both directions are stored if undirected
+//each neighbor list is sorted as (target << 32 | weight) pairs so weights stay with their targets
+//O(n + m log d) time, d = maximum degree
+csrGraph csrGraph::fromWeightedEdges(uint32_t n, const vector<weightedEdge>& edges, bool undirected) {
+	csrGraph g;
+	g.offsets.assign((size_t)n + 1, 0);
+	for (size_t i = 0; i < edges.size(); i++) {
+		g.offsets[edges[i].from + 1]++;
+		if (undirected)
+			g.offsets[edges[i].to + 1]++;
+	}
+	for (uint32_t v = 0; v < n; v++)
+		g.offsets[v + 1] += g.offsets[v];
+
+	vector<uint64_t> packed(g.offsets[n]);
+	vector<uint64_t> fill(g.offsets.begin(), g.offsets.end() - 1);
+	for (size_t i = 0; i < edges.size(); i++) {
+		packed[fill[edges[i].from]++] = ((uint64_t)edges[i].to << 32) | edges[i].weight;
+		if (undirected)
+			packed[fill[edges[i].to]++] = ((uint64_t)edges[i].from << 32) | edges[i].weight;
+	}
+
+	g.targets.resize(packed.size());
+	g.weights.resize(packed.size());
+	for (uint32_t v = 0; v < n; v++) {
+		sort(packed.begin() + g.offsets[v], packed.begin() + g.offsets[v + 1]);
+		for (uint64_t e = g.offsets[v]; e < g.offsets[v + 1]; e++) {
+			g.targets[e] = (uint32_t)(packed[e] >> 32);
+			g.weights[e] = (uint32_t)packed[e];
+		}
+	}
+	g.bind();
+	return g;
+}
+
+//graph with vertex v renamed newId[v], weights follow their edges
+//O(n + m log d) time
+csrGraph csrGraph::relabel(const vector<uint32_t>& newId) const {
+	uint32_t n = vertexCount();
+	csrGraph r;
+	r.offsets.assign((size_t)n + 1, 0);
+	for (uint32_t v = 0; v < n; v++)
+		r.offsets[newId[v] + 1] = degree(v);
+	for (uint32_t v = 0; v < n; v++)
+		r.offsets[v + 1] += r.offsets[v];
+
+	r.targets.resize(edgeCount());
+	r.weights.resize(weightData ? edgeCount() : 0);
+	vector<uint64_t> packed;
+	for (uint32_t v = 0; v < n; v++) {
+		uint64_t to = r.offsets[newId[v]];
+		packed.clear();
+		for (uint64_t e = offsetData[v]; e < offsetData[v + 1]; e++)
+			packed.push_back(((uint64_t)newId[targetData[e]] << 32) | (weightData ? weightData[e] : 0));
+		sort(packed.begin(), packed.end());
+		for (size_t i = 0; i < packed.size(); i++) {
+			r.targets[to + i] = (uint32_t)(packed[i] >> 32);
+			if (weightData)
+				r.weights[to + i] = (uint32_t)packed[i];
+		}
+	}
+	r.bind();
+	return r;
+}
+
+bfsEngine::bfsEngine(const csrGraph& out, const csrGraph& in) : out(out), in(in), stamp(out.vertexCount(), 0), depth(out.vertexCount(), 0) {}
+
+//visited marks are stamps of the current query, so starting a query is just a new stamp
+//each query uses two stamps, one per search direction
+void bfsEngine::newQuery() {
+	if (query >= 0xFFFFFFFDu) {
+		fill(stamp.begin(), stamp.end(), 0);
+		query = 0;
+	}
+	query += 2;
+}
+
+//hop distances from source, -1 where unreachable, switching between top down and bottom up levels
+//levels that scan fewer than parallelWork vertices and edges run inline, since runTasks starts threads per call
+//O(n + m) time
+vector<int> bfsEngine::distances(uint32_t source, unsigned threads) {
+	uint32_t n = out.vertexCount();
+	vector<int> dist(n, -1);
+	if (source >= n)
+		return dist;
+	if (threads == 0)
+		threads = max(1u, thread::hardware_concurrency());
+
+	const size_t chunk = 4096;
+	const uint64_t parallelWork = 1 << 16;
+	vertexBitset visited(n), frontierBits(n);
+	vector<uint32_t> frontier(1, source);
+	visited.set(source);
+	dist[source] = 0;
+
+	uint64_t frontierEdges = out.degree(source);
+	uint64_t unexplored = out.edgeCount();
+	bool bottomUp = false;
+
+	for (int level = 1; !frontier.empty(); level++) {
+		// Beamer's heuristic with alpha = 14, beta = 24
+		if (!bottomUp && frontierEdges > unexplored / 14)
+			bottomUp = true;
+		else if (bottomUp && frontier.size() < n / 24)
+			bottomUp = false;
+		unexplored -= min(unexplored, frontierEdges);
+
+		// top down scans the frontier's edges, bottom up scans every vertex plus edges into the unvisited ones
+		uint64_t work = bottomUp ? n + unexplored : frontier.size() + frontierEdges;
+		unsigned levelThreads = (work < parallelWork) ? 1 : threads;
+
+		size_t tasks;
+		vector<vector<uint32_t>> found;
+		vector<uint64_t> foundEdges;
+		if (!bottomUp) {
+			// top down: frontier vertices claim their unvisited neighbors
+			tasks = (frontier.size() + chunk - 1) / chunk;
+			found.resize(tasks);
+			foundEdges.assign(tasks, 0);
+			runTasks(tasks, levelThreads, [&](size_t t) {
+				size_t end = min(frontier.size(), (t + 1) * chunk);
+				for (size_t i = t * chunk; i < end; i++) {
+					for (const uint32_t* w = out.neighborsBegin(frontier[i]); w != out.neighborsEnd(frontier[i]); w++) {
+						if (visited.trySet(*w)) {
+							dist[*w] = level;
+							found[t].push_back(*w);
+							foundEdges[t] += out.degree(*w);
+						}
+					}
+				}
+			});
+		}
+		else {
+			frontierBits.clear();
+			for (size_t i = 0; i < frontier.size(); i++)
+				frontierBits.set(frontier[i]);
+
+			// bottom up: every unvisited vertex looks for any parent in the frontier
+			// chunks are multiples of 64 vertices, so each bitset word is written by a single task
+			tasks = (n + chunk - 1) / chunk;
+			found.resize(tasks);
+			foundEdges.assign(tasks, 0);
+			runTasks(tasks, levelThreads, [&](size_t t) {
+				uint32_t end = (uint32_t)min((size_t)n, (t + 1) * chunk);
+				for (uint32_t v = (uint32_t)(t * chunk); v < end; v++) {
+					if (visited.test(v))
+						continue;
+					for (const uint32_t* u = in.neighborsBegin(v); u != in.neighborsEnd(v); u++) {
+						if (frontierBits.test(*u)) {
+							visited.set(v);
+							dist[v] = level;
+							found[t].push_back(v);
+							foundEdges[t] += out.degree(v);
+							break;
+						}
+					}
+				}
+			});
+		}
+
+		// top down levels scan the list, bottom up levels rebuild the bitmap from it
+		frontier.clear();
+		frontierEdges = 0;
+		for (size_t t = 0; t < tasks; t++) {
+			frontier.insert(frontier.end(), found[t].begin(), found[t].end());
+			frontierEdges += foundEdges[t];
+		}
+	}
+	return dist;
+}
+
+//determines whether target is reachable from source, bidirectional
+//O(n + m) time worst case
+bool bfsEngine::reachable(uint32_t source, uint32_t target) {
+	return search(source, target, true) >= 0;
+}
+
+//hop distance from source to target, -1 if unreachable, bidirectional
+//O(n + m) time worst case
+int bfsEngine::distance(uint32_t source, uint32_t target) {
+	return search(source, target, false);
+}
+
+//grows a search from each end a level at a time, always the side whose frontier has fewer edges to scan
+//the first meeting answers reachability, the shortest meeting within that level gives the distance
+int bfsEngine::search(uint32_t source, uint32_t target, bool anyPath) {
+	uint32_t n = out.vertexCount();
+	if (source >= n || target >= n)
+		return -1;
+	if (source == target)
+		return 0;
+
+	newQuery();
+	stamp[source] = query;
+	stamp[target] = query + 1;
+	depth[source] = depth[target] = 0;
+	forward.assign(1, source);
+	backward.assign(1, target);
+
+	while (!forward.empty() && !backward.empty()) {
+		uint64_t forwardEdges = 0, backwardEdges = 0;
+		for (size_t i = 0; i < forward.size(); i++)
+			forwardEdges += out.degree(forward[i]);
+		for (size_t i = 0; i < backward.size(); i++)
+			backwardEdges += in.degree(backward[i]);
+
+		bool grow = forwardEdges <= backwardEdges;
+		vector<uint32_t>& frontier = grow ? forward : backward;
+		const csrGraph& g = grow ? out : in;
+		uint32_t mine = grow ? query : query + 1;
+		uint32_t other = grow ? query + 1 : query;
+
+		int best = -1;
+		next.clear();
+		for (size_t i = 0; i < frontier.size(); i++) {
+			uint32_t u = frontier[i];
+			for (const uint32_t* w = g.neighborsBegin(u); w != g.neighborsEnd(u); w++) {
+				if (stamp[*w] == other) {
+					int d = (int)(depth[u] + 1 + depth[*w]);
+					if (best < 0 || d < best)
+						best = d;
+					if (anyPath)
+						return best;
+				}
+				else if (stamp[*w] != mine) {
+					stamp[*w] = mine;
+					depth[*w] = depth[u] + 1;
+					next.push_back(*w);
+				}
+			}
+		}
+		if (best >= 0)
+			return best;
+		frontier.swap(next);
+	}
+	return -1;
+}
+
+concurrentUnionFind::concurrentUnionFind(uint32_t n) : entries(n) {
+	for (uint32_t v = 0; v < n; v++)
+		entries[v].store(v, memory_order_relaxed);
+}
+
+//root of v's set with path halving
+//a halving CAS only ever moves v closer to its root, so losing a race just skips that shortcut
+uint32_t concurrentUnionFind::find(uint32_t v) {
+	while (true) {
+		uint64_t e = entries[v].load(memory_order_acquire);
+		uint32_t p = parentOf(e);
+		if (p == v)
+			return v;
+		uint32_t gp = parentOf(entries[p].load(memory_order_acquire));
+		if (gp != p)
+			entries[v].compare_exchange_weak(e, ((uint64_t)rankOf(e) << 32) | gp, memory_order_release, memory_order_relaxed);
+		v = gp;
+	}
+}
+
+//merges the sets of a and b, returns whether they were separate
+//retries whenever the root it wants to link stops being a root or changes rank underneath it
+bool concurrentUnionFind::unite(uint32_t a, uint32_t b) {
+	while (true) {
+		a = find(a);
+		b = find(b);
+		if (a == b)
+			return false;
+
+		uint64_t ea = entries[a].load(memory_order_acquire);
+		uint64_t eb = entries[b].load(memory_order_acquire);
+		if (parentOf(ea) != a || parentOf(eb) != b)
+			continue;
+
+		// a becomes the child: lower rank, or equal rank and lower id
+		if (rankOf(ea) > rankOf(eb) || (rankOf(ea) == rankOf(eb) && a > b)) {
+			swap(a, b);
+			swap(ea, eb);
+		}
+		if (!entries[a].compare_exchange_strong(ea, ((uint64_t)rankOf(ea) << 32) | b, memory_order_acq_rel))
+			continue;
+
+		// bumping b's rank can only fail if b was linked meanwhile, ranks are a heuristic so that is harmless
+		if (rankOf(ea) == rankOf(eb))
+			entries[b].compare_exchange_strong(eb, ((uint64_t)(rankOf(eb) + 1) << 32) | b, memory_order_acq_rel);
+		return true;
+	}
+}
+
+//determines whether a and b are in the same set
+//different roots only prove separation if a's root is still a root afterwards
+bool concurrentUnionFind::connected(uint32_t a, uint32_t b) {
+	while (true) {
+		a = find(a);
+		b = find(b);
+		if (a == b)
+			return true;
+		if (parentOf(entries[a].load(memory_order_acquire)) == a)
+			return false;
+	}
+}
+
+//unites the endpoints of every edge, spread over threads
+//O(m α(n) / threads) time
+void concurrentUnionFind::addEdges(const vector<pair<uint32_t, uint32_t>>& edges, unsigned threads) {
+	const size_t chunk = 1 << 14;
+	runTasks((edges.size() + chunk - 1) / chunk, threads, [&](size_t t) {
+		size_t end = min(edges.size(), (t + 1) * chunk);
+		for (size_t i = t * chunk; i < end; i++)
+			unite(edges[i].first, edges[i].second);
+	});
+}
+
+//snapshot of component labels numbered in order of each component's smallest vertex
+//O(n α(n)) time
+vector<uint32_t> concurrentUnionFind::componentLabels() {
+	uint32_t n = size();
+	vector<uint32_t> labels(n);
+	vector<uint32_t> rootLabel(n, UINT32_MAX);
+	uint32_t next = 0;
+	for (uint32_t v = 0; v < n; v++) {
+		uint32_t r = find(v);
+		if (rootLabel[r] == UINT32_MAX)
+			rootLabel[r] = next++;
+		labels[v] = rootLabel[r];
+	}
+	return labels;
+}
+
+//number of disjoint sets
+//O(n) time
+uint32_t concurrentUnionFind::componentCount() const {
+	uint32_t count = 0;
+	for (uint32_t v = 0; v < size(); v++)
+		count += parentOf(entries[v].load(memory_order_relaxed)) == v;
+	return count;
+}
+
+namespace {
+
+// min-heap for Dijkstra keyed by distance, valid because popped keys never decrease
+// bucket 0 holds keys equal to the last popped key, bucket i keys whose highest bit differing from it is bit i-1
+struct radixHeap
+{
+	vector<pair<uint64_t, uint32_t>> buckets[65];
+	uint64_t last = 0;
+	size_t count = 0;
+
+	static int bucketOf(uint64_t key, uint64_t last) {
+		return key == last ? 0 : 64 - __builtin_clzll(key ^ last);
+	}
+
+	void push(uint64_t key, uint32_t v) {
+		buckets[bucketOf(key, last)].push_back(make_pair(key, v));
+		count++;
+	}
+
+	pair<uint64_t, uint32_t> pop() {
+		if (buckets[0].empty()) {
+			// redistribute the first non-empty bucket around its minimum, every entry lands in a lower bucket
+			int i = 1;
+			while (buckets[i].empty())
+				i++;
+			last = buckets[i][0].first;
+			for (size_t j = 1; j < buckets[i].size(); j++)
+				last = min(last, buckets[i][j].first);
+			for (size_t j = 0; j < buckets[i].size(); j++)
+				buckets[bucketOf(buckets[i][j].first, last)].push_back(buckets[i][j]);
+			buckets[i].clear();
+		}
+		pair<uint64_t, uint32_t> top = buckets[0].back();
+		buckets[0].pop_back();
+		count--;
+		return top;
+	}
+};
+
+}
+
+//single source shortest paths with Dijkstra's algorithm on a radix heap
+//stale heap entries are skipped instead of decreasing keys in place
+//O(m + n log C) time, C = largest edge weight
+vector<uint64_t> dijkstra(const csrGraph& g, uint32_t source) {
+	vector<uint64_t> dist(g.vertexCount(), infiniteDistance);
+	if (source >= g.vertexCount())
+		return dist;
+
+	radixHeap heap;
+	dist[source] = 0;
+	heap.push(0, source);
+	while (heap.count > 0) {
+		pair<uint64_t, uint32_t> top = heap.pop();
+		uint32_t u = top.second;
+		if (top.first > dist[u])
+			continue;
+		for (uint64_t e = g.edgesBegin(u); e < g.edgesEnd(u); e++) {
+			uint32_t w = g.edgeTarget(e);
+			uint64_t nd = top.first + g.edgeWeight(e);
+			if (nd < dist[w]) {
+				dist[w] = nd;
+				heap.push(nd, w);
+			}
+		}
+	}
+	return dist;
+}
+
+//single source shortest paths with parallel delta-stepping
+//distances are lowered with compare-and-swap, buckets are kept in a ring of max weight / delta + 2 slots
+//since every queued vertex lies within one max weight of the current bucket
+vector<uint64_t> deltaStepping(const csrGraph& g, uint32_t source, uint64_t delta, unsigned threads) {
+	uint32_t n = g.vertexCount();
+	vector<uint64_t> result(n, infiniteDistance);
+	if (source >= n)
+		return result;
+
+	uint64_t maxWeight = 1, totalWeight = 0;
+	for (uint64_t e = 0; e < g.edgeCount(); e++) {
+		maxWeight = max(maxWeight, (uint64_t)g.edgeWeight(e));
+		totalWeight += g.edgeWeight(e);
+	}
+	if (delta == 0)
+		delta = max((uint64_t)1, g.edgeCount() ? totalWeight / g.edgeCount() : 1);
+
+	vector<atomic<uint64_t>> dist(n);
+	for (uint32_t v = 0; v < n; v++)
+		dist[v].store(infiniteDistance, memory_order_relaxed);
+	dist[source].store(0, memory_order_relaxed);
+
+	const uint64_t none = UINT64_MAX;
+	size_t ring = (size_t)(maxWeight / delta) + 2;
+	vector<vector<uint32_t>> buckets(ring);
+	vector<uint64_t> queuedIn(n, none);
+	buckets[0].push_back(source);
+	queuedIn[source] = 0;
+
+	// relaxes the light or heavy edges of every vertex in from, then queues the vertices that improved
+	const size_t chunk = 1024;
+	vector<vector<uint32_t>> improved;
+	auto relax = [&](const vector<uint32_t>& from, bool light) {
+		size_t tasks = (from.size() + chunk - 1) / chunk;
+		improved.assign(tasks, vector<uint32_t>());
+		runTasks(tasks, threads, [&](size_t t) {
+			size_t end = min(from.size(), (t + 1) * chunk);
+			for (size_t i = t * chunk; i < end; i++) {
+				uint32_t u = from[i];
+				uint64_t du = dist[u].load(memory_order_relaxed);
+				for (uint64_t e = g.edgesBegin(u); e < g.edgesEnd(u); e++) {
+					uint64_t weight = g.edgeWeight(e);
+					if ((weight <= delta) != light)
+						continue;
+					uint32_t w = g.edgeTarget(e);
+					uint64_t nd = du + weight;
+					uint64_t cur = dist[w].load(memory_order_relaxed);
+					while (nd < cur) {
+						if (dist[w].compare_exchange_weak(cur, nd, memory_order_relaxed)) {
+							improved[t].push_back(w);
+							break;
+						}
+					}
+				}
+			}
+		});
+		for (size_t t = 0; t < improved.size(); t++) {
+			for (size_t i = 0; i < improved[t].size(); i++) {
+				uint32_t w = improved[t][i];
+				uint64_t b = dist[w].load(memory_order_relaxed) / delta;
+				if (queuedIn[w] != b) {
+					queuedIn[w] = b;
+					buckets[b % ring].push_back(w);
+				}
+			}
+		}
+	};
+
+	vector<uint32_t> frontier, settled;
+	for (uint64_t i = 0; ; i++) {
+		// skip to the next non-empty bucket, all ring slots empty means every vertex is settled
+		uint64_t next = i;
+		while (next < i + ring && buckets[next % ring].empty())
+			next++;
+		if (next == i + ring)
+			break;
+		i = next;
+
+		settled.clear();
+		while (!buckets[i % ring].empty()) {
+			frontier.clear();
+			vector<uint32_t>& bucket = buckets[i % ring];
+			for (size_t k = 0; k < bucket.size(); k++) {
+				uint32_t v = bucket[k];
+				// drop entries left behind when a vertex moved to a lower bucket
+				if (queuedIn[v] != i)
+					continue;
+				queuedIn[v] = none;
+				frontier.push_back(v);
+			}
+			bucket.clear();
+			settled.insert(settled.end(), frontier.begin(), frontier.end());
+			relax(frontier, true);
+		}
+		relax(settled, false);
+	}
+
+	for (uint32_t v = 0; v < n; v++)
+		result[v] = dist[v].load(memory_order_relaxed);
+	return result;
+}
+
+shortestPathEngine::shortestPathEngine(const csrGraph& out, const csrGraph& in)
+	: out(out), in(in), forwardDist(out.vertexCount()), backwardDist(out.vertexCount()),
+	forwardSeen(out.vertexCount(), 0), backwardSeen(out.vertexCount(), 0),
+	forwardHeap(out.vertexCount()), backwardHeap(out.vertexCount()) {}
+
+//starts a query by moving to a fresh stamp, clearing the stamps only when they wrap around
+void shortestPathEngine::newQuery() {
+	if (++query == 0) {
+		fill(forwardSeen.begin(), forwardSeen.end(), 0);
+		fill(backwardSeen.begin(), backwardSeen.end(), 0);
+		query = 1;
+	}
+}
+
+//shortest distance from source to target with bidirectional Dijkstra
+//stops once the two heap minimums add up to at least the best meeting found, no shorter path can remain
+uint64_t shortestPathEngine::distance(uint32_t source, uint32_t target) {
+	if (source >= out.vertexCount() || target >= out.vertexCount())
+		return infiniteDistance;
+	if (source == target)
+		return 0;
+
+	newQuery();
+	setDistance(forwardSeen, forwardDist, source, 0);
+	setDistance(backwardSeen, backwardDist, target, 0);
+	forwardHeap.push(source, 0);
+	backwardHeap.push(target, 0);
+
+	uint64_t best = infiniteDistance;
+	while (!forwardHeap.empty() && !backwardHeap.empty()) {
+		if (forwardHeap.topKey() + backwardHeap.topKey() >= best)
+			break;
+
+		bool forward = forwardHeap.size() <= backwardHeap.size();
+		const csrGraph& g = forward ? out : in;
+		indexedDaryHeap<uint64_t>& heap = forward ? forwardHeap : backwardHeap;
+		vector<uint32_t>& seen = forward ? forwardSeen : backwardSeen;
+		vector<uint64_t>& dist = forward ? forwardDist : backwardDist;
+		const vector<uint32_t>& otherSeen = forward ? backwardSeen : forwardSeen;
+		const vector<uint64_t>& otherDist = forward ? backwardDist : forwardDist;
+
+		uint32_t u = heap.pop();
+		uint64_t du = dist[u];
+		for (uint64_t e = g.edgesBegin(u); e < g.edgesEnd(u); e++) {
+			uint32_t w = g.edgeTarget(e);
+			uint64_t nd = du + g.edgeWeight(e);
+			if (nd < distanceOf(seen, dist, w)) {
+				setDistance(seen, dist, w, nd);
+				heap.push(w, nd);
+			}
+			uint64_t other = distanceOf(otherSeen, otherDist, w);
+			if (other != infiniteDistance && nd + other < best)
+				best = nd + other;
+		}
+	}
+	forwardHeap.clear();
+	backwardHeap.clear();
+	return best;
+}
+
+//connected components with Afforest
+//O(m α(n) / threads) time
+vector<uint32_t> connectedComponents(const csrGraph& g, bool undirected, unsigned threads) {
+	uint32_t n = g.vertexCount();
+	concurrentUnionFind sets(n);
+	const size_t chunk = 1 << 14;
+	size_t tasks = (n + chunk - 1) / chunk;
+	const uint32_t rounds = 2;
+
+	// link each vertex to its first neighbors, which usually merges the giant component early
+	for (uint32_t r = 0; r < rounds; r++) {
+		runTasks(tasks, threads, [&](size_t t) {
+			uint32_t end = (uint32_t)min((size_t)n, (t + 1) * chunk);
+			for (uint32_t v = (uint32_t)(t * chunk); v < end; v++) {
+				if (r < g.degree(v))
+					sets.unite(v, g.neighborsBegin(v)[r]);
+			}
+		});
+	}
+
+	// most frequent root among a sample of vertices
+	uint32_t skip = UINT32_MAX;
+	if (undirected && n > 0) {
+		mt19937 rng(n);
+		unordered_map<uint32_t, uint32_t> freq;
+		uint32_t best = 0;
+		for (int i = 0; i < 1024; i++) {
+			uint32_t root = sets.find(rng() % n);
+			if (++freq[root] > best) {
+				best = freq[root];
+				skip = root;
+			}
+		}
+	}
+
+	// remaining edges, vertices already in the largest component are reached from the other side of each edge
+	runTasks(tasks, threads, [&](size_t t) {
+		uint32_t end = (uint32_t)min((size_t)n, (t + 1) * chunk);
+		for (uint32_t v = (uint32_t)(t * chunk); v < end; v++) {
+			if (skip != UINT32_MAX && sets.find(v) == sets.find(skip))
+				continue;
+			for (uint32_t i = rounds; i < g.degree(v); i++)
+				sets.unite(v, g.neighborsBegin(v)[i]);
+		}
+	});
+	return sets.componentLabels();
+}
+
+//strongly connected components with an iterative Tarjan walk
+//an explicit frame stack holds (vertex, next edge) in place of recursion
+//O(n + m) time
+vector<uint32_t> stronglyConnectedComponents(const csrGraph& g, uint32_t& count) {
+	const uint32_t unvisited = UINT32_MAX;
+	uint32_t n = g.vertexCount();
+	vector<uint32_t> comp(n, unvisited), index(n, unvisited), low(n);
+	vector<uint32_t> stack;
+	vector<pair<uint32_t, uint64_t>> frames;
+	uint32_t nextIndex = 0;
+	count = 0;
+
+	for (uint32_t root = 0; root < n; root++) {
+		if (index[root] != unvisited)
+			continue;
+		frames.push_back(make_pair(root, g.edgesBegin(root)));
+		index[root] = low[root] = nextIndex++;
+		stack.push_back(root);
+
+		while (!frames.empty()) {
+			uint32_t v = frames.back().first;
+			uint64_t& e = frames.back().second;
+			if (e < g.edgesEnd(v)) {
+				uint32_t w = g.edgeTarget(e++);
+				if (index[w] == unvisited) {
+					index[w] = low[w] = nextIndex++;
+					stack.push_back(w);
+					frames.push_back(make_pair(w, g.edgesBegin(w)));
+				}
+				else if (comp[w] == unvisited)
+					low[v] = min(low[v], index[w]);
+				continue;
+			}
+
+			// all edges done, v roots a component if nothing below it reached higher
+			frames.pop_back();
+			if (low[v] == index[v]) {
+				uint32_t w;
+				do {
+					w = stack.back();
+					stack.pop_back();
+					comp[w] = count;
+				} while (w != v);
+				count++;
+			}
+			if (!frames.empty())
+				low[frames.back().first] = min(low[frames.back().first], low[v]);
+		}
+	}
+	return comp;
+}
+
+//topological order with Kahn's algorithm and parallel frontiers
+//in-degrees are decremented atomically, the thread taking one to zero owns that vertex for the next frontier
+//O(n + m) time
+bool topologicalSort(const csrGraph& g, vector<uint32_t>& order, unsigned threads) {
+	uint32_t n = g.vertexCount();
+	vector<atomic<uint32_t>> inDegree(n);
+	for (uint32_t v = 0; v < n; v++)
+		inDegree[v].store(0, memory_order_relaxed);
+	for (uint64_t e = 0; e < g.edgeCount(); e++)
+		inDegree[g.edgeTarget(e)].fetch_add(1, memory_order_relaxed);
+
+	order.clear();
+	order.reserve(n);
+	for (uint32_t v = 0; v < n; v++) {
+		if (inDegree[v].load(memory_order_relaxed) == 0)
+			order.push_back(v);
+	}
+
+	const size_t chunk = 1024;
+	vector<vector<uint32_t>> found;
+	for (size_t begin = 0; begin < order.size(); ) {
+		size_t end = order.size();
+		size_t tasks = (end - begin + chunk - 1) / chunk;
+		found.assign(tasks, vector<uint32_t>());
+		runTasks(tasks, threads, [&](size_t t) {
+			size_t last = min(end, begin + (t + 1) * chunk);
+			for (size_t i = begin + t * chunk; i < last; i++) {
+				uint32_t v = order[i];
+				for (const uint32_t* w = g.neighborsBegin(v); w != g.neighborsEnd(v); w++) {
+					if (inDegree[*w].fetch_sub(1, memory_order_acq_rel) == 1)
+						found[t].push_back(*w);
+				}
+			}
+		});
+		for (size_t t = 0; t < tasks; t++)
+			order.insert(order.end(), found[t].begin(), found[t].end());
+		begin = end;
+	}
+	return order.size() == n;
+}
+
+//reverse Cuthill-McKee order, newId[v] is the position of v
+//O(n + m log d) time
+vector<uint32_t> reverseCuthillMcKee(const csrGraph& g) {
+	uint32_t n = g.vertexCount();
+	vector<uint32_t> order;
+	order.reserve(n);
+	vector<char> placed(n, 0);
+
+	// components start from their lowest degree vertex, so scan vertices by increasing degree
+	vector<uint32_t> byDegree = degreeOrder(g);
+	vector<uint32_t> starts(n);
+	for (uint32_t v = 0; v < n; v++)
+		starts[n - 1 - byDegree[v]] = v;
+
+	vector<uint32_t> adj;
+	for (uint32_t i = 0; i < n; i++) {
+		if (placed[starts[i]])
+			continue;
+		size_t head = order.size();
+		order.push_back(starts[i]);
+		placed[starts[i]] = 1;
+		for (; head < order.size(); head++) {
+			uint32_t v = order[head];
+			adj.clear();
+			for (const uint32_t* w = g.neighborsBegin(v); w != g.neighborsEnd(v); w++) {
+				if (!placed[*w]) {
+					placed[*w] = 1;
+					adj.push_back(*w);
+				}
+			}
+			sort(adj.begin(), adj.end(), [&g](uint32_t a, uint32_t b) {
+				return g.degree(a) < g.degree(b) || (g.degree(a) == g.degree(b) && a < b);
+			});
+			order.insert(order.end(), adj.begin(), adj.end());
+		}
+	}
+
+	vector<uint32_t> newId(n);
+	for (uint32_t i = 0; i < n; i++)
+		newId[order[i]] = n - 1 - i;
+	return newId;
+}
+
+//hubs first by counting sort on degree, newId[v] is the position of v
+//O(n) time
+vector<uint32_t> degreeOrder(const csrGraph& g) {
+	uint32_t n = g.vertexCount();
+	uint32_t maxDegree = 0;
+	for (uint32_t v = 0; v < n; v++)
+		maxDegree = max(maxDegree, g.degree(v));
+
+	// bucket starts for decreasing degree
+	vector<uint32_t> start((size_t)maxDegree + 2, 0);
+	for (uint32_t v = 0; v < n; v++)
+		start[maxDegree - g.degree(v) + 1]++;
+	for (uint32_t d = 0; d <= maxDegree; d++)
+		start[d + 1] += start[d];
+
+	vector<uint32_t> newId(n);
+	for (uint32_t v = 0; v < n; v++)
+		newId[v] = start[maxDegree - g.degree(v)]++;
+	return newId;
+}
+
+//Gorder-style greedy order, newId[v] is the position of v
+//score[u] counts edges and common neighbors between u and the placed window; every placement adds to the scores
+//around the new vertex and the vertex leaving the window subtracts its share, with stale heap entries skipped
+vector<uint32_t> gorderLite(const csrGraph& g, uint32_t window) {
+	uint32_t n = g.vertexCount();
+	vector<uint32_t> newId(n, UINT32_MAX);
+	if (n == 0)
+		return newId;
+	uint32_t hub = max(2u, (uint32_t)sqrt((double)n));
+
+	vector<int64_t> score(n, 0);
+	priority_queue<pair<int64_t, uint32_t>> heap;
+	auto update = [&](uint32_t v, int64_t delta) {
+		for (const uint32_t* x = g.neighborsBegin(v); x != g.neighborsEnd(v); x++) {
+			if (newId[*x] == UINT32_MAX) {
+				score[*x] += delta;
+				if (delta > 0)
+					heap.push(make_pair(score[*x], *x));
+			}
+			// common neighbors through x, skipped for hubs
+			if (g.degree(*x) > hub)
+				continue;
+			for (const uint32_t* u = g.neighborsBegin(*x); u != g.neighborsEnd(*x); u++) {
+				if (*u != v && newId[*u] == UINT32_MAX) {
+					score[*u] += delta;
+					if (delta > 0)
+						heap.push(make_pair(score[*u], *u));
+				}
+			}
+		}
+	};
+
+	// unconnected vertices and new components are seeded in degree order
+	vector<uint32_t> byDegree = degreeOrder(g);
+	vector<uint32_t> seeds(n);
+	for (uint32_t v = 0; v < n; v++)
+		seeds[byDegree[v]] = v;
+
+	vector<uint32_t> order;
+	order.reserve(n);
+	size_t seed = 0;
+	while (order.size() < n) {
+		uint32_t next = UINT32_MAX;
+		while (!heap.empty()) {
+			pair<int64_t, uint32_t> top = heap.top();
+			heap.pop();
+			if (newId[top.second] == UINT32_MAX && top.first == score[top.second] && top.first > 0) {
+				next = top.second;
+				break;
+			}
+		}
+		if (next == UINT32_MAX) {
+			while (newId[seeds[seed]] != UINT32_MAX)
+				seed++;
+			next = seeds[seed];
+		}
+
+		newId[next] = (uint32_t)order.size();
+		order.push_back(next);
+		update(next, 1);
+		if (order.size() > window) {
+			uint32_t leaving = order[order.size() - 1 - window];
+			update(leaving, -1);
+			// lowered scores need fresh entries, the old higher ones are discarded as stale
+			for (const uint32_t* x = g.neighborsBegin(leaving); x != g.neighborsEnd(leaving); x++) {
+				if (newId[*x] == UINT32_MAX && score[*x] > 0)
+					heap.push(make_pair(score[*x], *x));
+				if (g.degree(*x) > hub)
+					continue;
+				for (const uint32_t* u = g.neighborsBegin(*x); u != g.neighborsEnd(*x); u++) {
+					if (newId[*u] == UINT32_MAX && score[*u] > 0)
+						heap.push(make_pair(score[*u], *u));
+				}
+			}
+		}
+	}
+	return newId;
+}
+
+namespace {
+
+// one level of the partitioner's hierarchy: a weighted graph plus the weight (fine vertex count) of each vertex
+struct partitionLevel
+{
+	csrGraph graph;
+	vector<uint32_t> vertexWeight;
+	vector<uint32_t> toCoarse;
+};
+
+// coarsens a level by heavy edge matching, fills next and the fine to coarse map, returns the coarse vertex count
+uint32_t coarsenLevel(partitionLevel& fine, partitionLevel& next, uint32_t maxVertexWeight, mt19937& rng) {
+	const csrGraph& g = fine.graph;
+	uint32_t n = g.vertexCount();
+	const uint32_t unmatched = UINT32_MAX;
+	vector<uint32_t>& coarse = fine.toCoarse;
+	coarse.assign(n, unmatched);
+
+	vector<uint32_t> visit(n);
+	for (uint32_t v = 0; v < n; v++)
+		visit[v] = v;
+	shuffle(visit.begin(), visit.end(), rng);
+
+	uint32_t nc = 0;
+	vector<uint32_t> members;
+	for (uint32_t i = 0; i < n; i++) {
+		uint32_t v = visit[i];
+		if (coarse[v] != unmatched)
+			continue;
+		uint32_t best = unmatched, bestWeight = 0;
+		for (uint64_t e = g.edgesBegin(v); e < g.edgesEnd(v); e++) {
+			uint32_t u = g.edgeTarget(e);
+			if (u == v || coarse[u] != unmatched || fine.vertexWeight[u] + fine.vertexWeight[v] > maxVertexWeight)
+				continue;
+			if (best == unmatched || g.edgeWeight(e) > bestWeight) {
+				best = u;
+				bestWeight = g.edgeWeight(e);
+			}
+		}
+		coarse[v] = nc;
+		members.push_back(v);
+		if (best != unmatched) {
+			coarse[best] = nc;
+			members.push_back(best);
+		}
+		members.push_back(unmatched);
+		nc++;
+	}
+
+	// merge parallel edges by accumulating weights per coarse neighbor
+	next.vertexWeight.assign(nc, 0);
+	vector<weightedEdge> edges;
+	vector<uint32_t> acc(nc, 0), touched;
+	uint32_t c = 0;
+	for (size_t i = 0; i < members.size(); i++) {
+		uint32_t v = members[i];
+		if (v == unmatched) {
+			for (size_t j = 0; j < touched.size(); j++) {
+				weightedEdge edge = { c, touched[j], acc[touched[j]] };
+				edges.push_back(edge);
+				acc[touched[j]] = 0;
+			}
+			touched.clear();
+			c++;
+			continue;
+		}
+		next.vertexWeight[c] += fine.vertexWeight[v];
+		for (uint64_t e = g.edgesBegin(v); e < g.edgesEnd(v); e++) {
+			uint32_t cu = coarse[g.edgeTarget(e)];
+			if (cu == c)
+				continue;
+			if (acc[cu] == 0)
+				touched.push_back(cu);
+			acc[cu] += g.edgeWeight(e);
+		}
+	}
+	next.graph = csrGraph::fromWeightedEdges(nc, edges);
+	return nc;
+}
+
+// greedy boundary refinement: moves vertices to the neighboring part they are most connected to while parts stay
+// under maxPartWeight, vertices of overweight parts move to the best part with room even at a loss
+void refinePartition(const partitionLevel& level, vector<uint32_t>& part, vector<uint64_t>& partWeight, uint32_t k, uint64_t maxPartWeight) {
+	const csrGraph& g = level.graph;
+	uint32_t n = g.vertexCount();
+	vector<int64_t> conn(k, 0);
+	vector<uint32_t> touched;
+
+	for (int pass = 0; pass < 4; pass++) {
+		bool moved = false;
+		for (uint32_t v = 0; v < n; v++) {
+			uint32_t own = part[v];
+			touched.clear();
+			for (uint64_t e = g.edgesBegin(v); e < g.edgesEnd(v); e++) {
+				uint32_t p = part[g.edgeTarget(e)];
+				if (conn[p] == 0)
+					touched.push_back(p);
+				conn[p] += g.edgeWeight(e);
+			}
+
+			bool overweight = partWeight[own] > maxPartWeight;
+			uint32_t best = own;
+			int64_t bestGain = 0;
+			for (size_t i = 0; i < touched.size(); i++) {
+				uint32_t p = touched[i];
+				if (p == own || partWeight[p] + level.vertexWeight[v] > maxPartWeight)
+					continue;
+				int64_t gain = conn[p] - conn[own];
+				if ((best == own && (gain > 0 || overweight)) || (best != own && gain > bestGain)) {
+					best = p;
+					bestGain = gain;
+				}
+			}
+			// an overweight part with no room among its neighbors' parts gives the vertex to the lightest part
+			if (best == own && overweight) {
+				uint32_t lightest = (uint32_t)(min_element(partWeight.begin(), partWeight.end()) - partWeight.begin());
+				if (partWeight[lightest] + level.vertexWeight[v] <= maxPartWeight)
+					best = lightest;
+			}
+			for (size_t i = 0; i < touched.size(); i++)
+				conn[touched[i]] = 0;
+
+			if (best != own) {
+				partWeight[own] -= level.vertexWeight[v];
+				partWeight[best] += level.vertexWeight[v];
+				part[v] = best;
+				moved = true;
+			}
+		}
+		if (!moved)
+			break;
+	}
+}
+
+}
+
+//multilevel k-way partition of an undirected graph
+//O((n + m) log n) time
+vector<uint32_t> partitionGraph(const csrGraph& g, uint32_t k, double imbalance) {
+	uint32_t n = g.vertexCount();
+	if (k <= 1 || n == 0)
+		return vector<uint32_t>(n, 0);
+	k = min(k, n);
+
+	// level 0 is g with unit weights, multiple edges between coarse vertices add up
+	vector<partitionLevel> levels(1);
+	vector<weightedEdge> edges;
+	edges.reserve(g.edgeCount());
+	for (uint32_t v = 0; v < n; v++) {
+		for (uint64_t e = g.edgesBegin(v); e < g.edgesEnd(v); e++) {
+			weightedEdge edge = { v, g.edgeTarget(e), 1 };
+			edges.push_back(edge);
+		}
+	}
+	levels[0].graph = csrGraph::fromWeightedEdges(n, edges);
+	vector<weightedEdge>().swap(edges);
+	levels[0].vertexWeight.assign(n, 1);
+
+	uint64_t maxPartWeight = (uint64_t)ceil(imbalance * n / k);
+	uint32_t maxVertexWeight = (uint32_t)max((uint64_t)1, (uint64_t)n / (4 * k));
+	mt19937 rng(k);
+	while (levels.back().graph.vertexCount() > 32 * k) {
+		partitionLevel next;
+		uint32_t before = levels.back().graph.vertexCount();
+		uint32_t after = coarsenLevel(levels.back(), next, maxVertexWeight, rng);
+		if (after > before - before / 20)
+			break;
+		levels.push_back(move(next));
+	}
+	levels.back().toCoarse.clear();
+
+	// initial partition: consecutive chunks of a breadth first order by accumulated vertex weight
+	const partitionLevel& top = levels.back();
+	uint32_t nc = top.graph.vertexCount();
+	vector<uint32_t> order;
+	order.reserve(nc);
+	vector<char> seen(nc, 0);
+	for (uint32_t s = 0; s < nc; s++) {
+		if (seen[s])
+			continue;
+		seen[s] = 1;
+		size_t head = order.size();
+		order.push_back(s);
+		for (; head < order.size(); head++) {
+			uint32_t v = order[head];
+			for (const uint32_t* w = top.graph.neighborsBegin(v); w != top.graph.neighborsEnd(v); w++) {
+				if (!seen[*w]) {
+					seen[*w] = 1;
+					order.push_back(*w);
+				}
+			}
+		}
+	}
+	vector<uint32_t> part(nc);
+	vector<uint64_t> partWeight(k, 0);
+	uint64_t placed = 0;
+	for (uint32_t i = 0; i < nc; i++) {
+		uint32_t v = order[i];
+		uint32_t p = (uint32_t)min((uint64_t)k - 1, placed * k / n);
+		part[v] = p;
+		partWeight[p] += top.vertexWeight[v];
+		placed += top.vertexWeight[v];
+	}
+	refinePartition(top, part, partWeight, k, maxPartWeight);
+
+	// project each level onto the finer one and refine
+	for (size_t l = levels.size() - 1; l-- > 0; ) {
+		const partitionLevel& fine = levels[l];
+		vector<uint32_t> finePart(fine.graph.vertexCount());
+		for (uint32_t v = 0; v < fine.graph.vertexCount(); v++)
+			finePart[v] = part[fine.toCoarse[v]];
+		part.swap(finePart);
+		refinePartition(fine, part, partWeight, k, maxPartWeight);
+	}
+	return part;
+}
+
+//number of undirected edges crossing parts
+//O(m) time
+uint64_t partitionCut(const csrGraph& g, const vector<uint32_t>& part) {
+	uint64_t crossing = 0;
+	for (uint32_t v = 0; v < g.vertexCount(); v++) {
+		for (const uint32_t* w = g.neighborsBegin(v); w != g.neighborsEnd(v); w++)
+			crossing += part[v] != part[*w];
+	}
+	return crossing / 2;
+}
+
+namespace {
+
+// layout of the first 64 bytes of a csr file, array positions are byte offsets from the start of the file
+struct csrFileHeader
+{
+	char magic[8];
+	uint32_t byteOrder;
+	uint32_t flags;
+	uint64_t vertexCount;
+	uint64_t edgeCount;
+	uint64_t offsetsAt;
+	uint64_t targetsAt;
+	uint64_t weightsAt;
+	uint64_t fileSize;
+};
+
+}
+
+const char csrFileMagic[8] = { 'C', 'S', 'R', 'G', 'R', 'A', 'P', 'H' };
+const uint32_t csrByteOrder = 0x01020304;
+const uint32_t csrWeighted = 1;
+
+// rounds pos up to the next multiple of 64
+static uint64_t alignTo64(uint64_t pos) {
+	return (pos + 63) & ~(uint64_t)63;
+}
+
+// writes size bytes of data and then zero padding up to the next 64 byte boundary
+static bool writeAligned(FILE* f, const void* data, uint64_t size) {
+	static const char zeros[64] = {};
+	if (size > 0 && fwrite(data, 1, (size_t)size, f) != size)
+		return false;
+	uint64_t pad = alignTo64(size) - size;
+	return pad == 0 || fwrite(zeros, 1, (size_t)pad, f) == pad;
+}
+
+//writes the graph in the csr file format
+//O(n + m) time
+bool csrGraph::writeFile(const char* path) const {
+	csrFileHeader header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, csrFileMagic, sizeof(header.magic));
+	header.byteOrder = csrByteOrder;
+	header.flags = weightData ? csrWeighted : 0;
+	header.vertexCount = n;
+	header.edgeCount = m;
+	header.offsetsAt = sizeof(csrFileHeader);
+	header.targetsAt = alignTo64(header.offsetsAt + ((uint64_t)n + 1) * sizeof(uint64_t));
+	header.weightsAt = weightData ? alignTo64(header.targetsAt + m * sizeof(uint32_t)) : 0;
+	header.fileSize = (weightData ? header.weightsAt : header.targetsAt) + m * sizeof(uint32_t);
+
+	FILE* f = fopen(path, "wb");
+	if (f == nullptr)
+		return false;
+	bool ok = fwrite(&header, sizeof(header), 1, f) == 1
+		&& writeAligned(f, offsetData, ((uint64_t)n + 1) * sizeof(uint64_t))
+		&& (weightData ? writeAligned(f, targetData, m * sizeof(uint32_t)) : fwrite(targetData, sizeof(uint32_t), (size_t)m, f) == m)
+		&& (!weightData || fwrite(weightData, sizeof(uint32_t), (size_t)m, f) == m);
+	return fclose(f) == 0 && ok;
+}
+
+// determines whether bytes bytes starting at at fit in a file of size bytes after the header, without overflowing
+static bool csrSectionFits(uint64_t at, uint64_t bytes, uint64_t size) {
+	return at >= sizeof(csrFileHeader) && at <= size && bytes <= size - at;
+}
+
+// determines whether the byte ranges [a, a + aBytes) and [b, b + bBytes) share a byte, both known to fit the file
+static bool csrSectionsOverlap(uint64_t a, uint64_t aBytes, uint64_t b, uint64_t bBytes) {
+	return aBytes > 0 && bBytes > 0 && a < b + bBytes && b < a + aBytes;
+}
+
+//opens a file written by writeFile, mapping it read-only where mmap is available
+//only the header, the section bounds and the first and last offsets are checked, the arrays are trusted as written
+bool csrGraph::mapFile(const char* path, csrGraph& g) {
+	const char* base = nullptr;
+	uint64_t size = 0;
+	shared_ptr<const void> keeper;
+
+#if defined(__unix__) || defined(__APPLE__)
+	int fd = open(path, O_RDONLY);
+	if (fd < 0)
+		return false;
+	struct stat info;
+	if (fstat(fd, &info) != 0 || info.st_size < (off_t)sizeof(csrFileHeader)) {
+		close(fd);
+		return false;
+	}
+	size = (uint64_t)info.st_size;
+	void* addr = mmap(nullptr, (size_t)size, PROT_READ, MAP_SHARED, fd, 0);
+	// the mapping stays valid after the descriptor is closed
+	close(fd);
+	if (addr == MAP_FAILED)
+		return false;
+	size_t length = (size_t)size;
+	keeper = shared_ptr<const void>(addr, [length](const void* p) { munmap(const_cast<void*>(p), length); });
+	base = (const char*)addr;
+#else
+	FILE* f = fopen(path, "rb");
+	if (f == nullptr)
+		return false;
+	fseek(f, 0, SEEK_END);
+	long end = ftell(f);
+	fseek(f, 0, SEEK_SET);
+	if (end < (long)sizeof(csrFileHeader)) {
+		fclose(f);
+		return false;
+	}
+	size = (uint64_t)end;
+	// 8 byte elements keep the offsets array aligned
+	shared_ptr<vector<uint64_t>> buffer = make_shared<vector<uint64_t>>((size_t)((size + 7) / 8));
+	bool read = fread(buffer->data(), 1, (size_t)size, f) == size;
+	fclose(f);
+	if (!read)
+		return false;
+	keeper = buffer;
+	base = (const char*)buffer->data();
+#endif
+
+	csrFileHeader header;
+	memcpy(&header, base, sizeof(header));
+	uint64_t n = header.vertexCount, m = header.edgeCount;
+	bool weighted = (header.flags & csrWeighted) != 0;
+	if (memcmp(header.magic, csrFileMagic, sizeof(header.magic)) != 0 || header.byteOrder != csrByteOrder)
+		return false;
+	if (header.fileSize != size || n > UINT32_MAX || m > size)
+		return false;
+	if (header.offsetsAt % 64 != 0 || header.targetsAt % 64 != 0 || header.weightsAt % 64 != 0)
+		return false;
+
+	// n and m are bounded above, so the section lengths can't overflow; the fit checks subtract rather than add
+	uint64_t offsetBytes = (n + 1) * sizeof(uint64_t);
+	uint64_t edgeBytes = m * sizeof(uint32_t);
+	if (!csrSectionFits(header.offsetsAt, offsetBytes, size) || !csrSectionFits(header.targetsAt, edgeBytes, size))
+		return false;
+	if (csrSectionsOverlap(header.offsetsAt, offsetBytes, header.targetsAt, edgeBytes))
+		return false;
+	if (weighted) {
+		if (!csrSectionFits(header.weightsAt, edgeBytes, size))
+			return false;
+		if (csrSectionsOverlap(header.weightsAt, edgeBytes, header.offsetsAt, offsetBytes) ||
+			csrSectionsOverlap(header.weightsAt, edgeBytes, header.targetsAt, edgeBytes))
+			return false;
+	}
+
+	const uint64_t* offsets = (const uint64_t*)(base + header.offsetsAt);
+	if (offsets[0] != 0 || offsets[n] != m)
+		return false;
+
+	csrGraph view;
+	view.offsets.clear();
+	view.offsetData = offsets;
+	view.targetData = (const uint32_t*)(base + header.targetsAt);
+	view.weightData = weighted ? (const uint32_t*)(base + header.weightsAt) : nullptr;
+	view.n = (uint32_t)n;
+	view.m = m;
+	view.mapping = keeper;
+	g = move(view);
+	return true;
+}
+
+//checks the invariants mapFile does not: offsets never decrease, every target is a vertex, neighbor lists are sorted
+//each offset is bounded by m before its neighbor list is read, so a corrupt file is never read past its targets
+//O(n + m) time
+bool csrGraph::validate() const {
+	if (offsetData[0] != 0 || offsetData[n] != m)
+		return false;
+	for (uint32_t v = 0; v < n; v++) {
+		if (offsetData[v + 1] < offsetData[v] || offsetData[v + 1] > m)
+			return false;
+		for (uint64_t e = offsetData[v]; e < offsetData[v + 1]; e++) {
+			if (targetData[e] >= n || (e > offsetData[v] && targetData[e] < targetData[e - 1]))
+				return false;
+		}
+	}
+	return true;
+}
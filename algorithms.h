@@ -3,6 +3,20 @@
 
 #include <string>
 #include <vector>
+#include <functional>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <random>
+#include <iterator>
+#include <set>
+#include <cmath>
+#include <thread>
+#include <atomic>
+#include <unordered_map>
+#include <cstdint>
+#include <memory>
+#include <iostream>
 
 /*
 * Definitions
@@ -35,6 +49,305 @@ struct graphNode
 	vector<graphNode*> connectedTo;
 };
 
+//slab allocator for nodes of type T (listNode<N>, treeNode<V>, ...)
+//nodes are carved out of large slabs that double in size, freed nodes go on a free list
+//release() drops every node at once without walking them, so T must be trivially destructible
+template<class T>
+class nodeArena
+{
+public:
+	nodeArena(size_t firstSlab = 1024) : nextSlab(firstSlab ? firstSlab : 1) {}
+	~nodeArena() { release(); }
+
+	//returns a value initialized node (null links, zero data), thread safe
+	//O(1) amortized time
+	T* allocate(){
+		lock_guard<mutex> guard(lock);
+		if(freeList){
+			freeNode* node = freeList;
+			freeList = node->next;
+			live++;
+			return new (node) T();
+		}
+		if(cur == end)
+			addSlab(1);
+		live++;
+		return new (cur++) T();
+	}
+
+	//puts node back on the free list for reuse, thread safe
+	//O(1) time
+	void deallocate(T* node){
+		lock_guard<mutex> guard(lock);
+		freeNode* f = reinterpret_cast<freeNode*>(node);
+		f->next = freeList;
+		freeList = f;
+		live--;
+	}
+
+	//frees every node allocated from this arena
+	//O(number of slabs) time
+	void release(){
+		lock_guard<mutex> guard(lock);
+		for(size_t i = 0; i < slabs.size(); i++)
+			::operator delete(slabs[i]);
+		slabs.clear();
+		cur = end = nullptr;
+		freeList = nullptr;
+		live = 0;
+	}
+
+	//number of nodes currently handed out
+	size_t size() const { return live; }
+
+	//hands out up to count raw nodes for a thread cache, thread safe
+	//freed nodes are reused first: they come back as a null terminated chain linked through their first word,
+	//with recycled set to its length and runEnd to its last node
+	//otherwise recycled is 0 and the nodes are the fresh run [returned, runEnd)
+	T* carve(size_t count, T*& runEnd, size_t& recycled){
+		lock_guard<mutex> guard(lock);
+		if(freeList){
+			freeNode* first = freeList;
+			freeNode* last = first;
+			recycled = 1;
+			while(recycled < count && last->next){
+				last = last->next;
+				recycled++;
+			}
+			freeList = last->next;
+			last->next = nullptr;
+			live += recycled;
+			runEnd = reinterpret_cast<T*>(last);
+			return reinterpret_cast<T*>(first);
+		}
+
+		recycled = 0;
+		if(cur == end)
+			addSlab(count);
+		T* begin = cur;
+		cur += min(count, (size_t)(end - cur));
+		runEnd = cur;
+		live += runEnd - begin;
+		return begin;
+	}
+
+	//takes back a chain of freed nodes from a thread cache, thread safe
+	void reclaim(T* first, T* last, size_t count){
+		lock_guard<mutex> guard(lock);
+		reinterpret_cast<freeNode*>(last)->next = freeList;
+		freeList = reinterpret_cast<freeNode*>(first);
+		live -= count;
+	}
+
+private:
+	static_assert(is_trivially_destructible<T>::value, "nodeArena releases nodes without running destructors");
+	static_assert(sizeof(T) >= sizeof(void*), "node too small to hold a free list link");
+
+	struct freeNode
+	{
+		freeNode* next;
+	};
+
+	void addSlab(size_t atLeast){
+		size_t count = max(nextSlab, atLeast);
+		T* slab = static_cast<T*>(::operator new(count * sizeof(T)));
+		slabs.push_back(slab);
+		cur = slab;
+		end = slab + count;
+		if(nextSlab < ((size_t)1 << 22))
+			nextSlab *= 2;
+	}
+
+	vector<T*> slabs;
+	T* cur = nullptr;
+	T* end = nullptr;
+	freeNode* freeList = nullptr;
+	size_t nextSlab;
+	size_t live = 0;
+	mutex lock;
+};
+
+//per-thread front end to a shared nodeArena
+//grabs nodes in batches so the arena lock is taken once per batch instead of once per node
+template<class T>
+class nodeArenaCache
+{
+public:
+	nodeArenaCache(nodeArena<T>& arena, size_t batch = 4096) : arena(arena), batch(batch ? batch : 1) {}
+	~nodeArenaCache() { flush(); }
+
+	//returns a value initialized node
+	//O(1) amortized time
+	T* allocate(){
+		if(freeList){
+			freeNode* node = freeList;
+			freeList = node->next;
+			freeCount--;
+			if(freeList == nullptr)
+				freeTail = nullptr;
+			return new (node) T();
+		}
+		if(cur == end){
+			size_t recycled = 0;
+			T* last = nullptr;
+			T* first = arena.carve(batch, last, recycled);
+			if(recycled){
+				// adopt the arena's recycled chain as this cache's free list
+				freeList = reinterpret_cast<freeNode*>(first);
+				freeTail = reinterpret_cast<freeNode*>(last);
+				freeCount = recycled;
+				return allocate();
+			}
+			cur = first;
+			end = last;
+		}
+		return new (cur++) T();
+	}
+
+	//keeps node on this thread's free list
+	//O(1) time
+	void deallocate(T* node){
+		freeNode* f = reinterpret_cast<freeNode*>(node);
+		f->next = freeList;
+		freeList = f;
+		if(freeTail == nullptr)
+			freeTail = f;
+		freeCount++;
+	}
+
+	//returns cached free nodes and the unused part of the current batch to the shared arena
+	void flush(){
+		while(cur != end)
+			deallocate(cur++);
+		if(freeList)
+			arena.reclaim(reinterpret_cast<T*>(freeList), reinterpret_cast<T*>(freeTail), freeCount);
+		freeList = freeTail = nullptr;
+		freeCount = 0;
+	}
+
+private:
+	struct freeNode
+	{
+		freeNode* next;
+	};
+
+	nodeArena<T>& arena;
+	size_t batch;
+	T* cur = nullptr;
+	T* end = nullptr;
+	freeNode* freeList = nullptr;
+	freeNode* freeTail = nullptr;
+	size_t freeCount = 0;
+};
+
+//builds a linked list holding values[0...size-1] in order with nodes from arena
+//O(n) time
+template<class N>
+listNode<N>* buildList(nodeArena<listNode<N>>& arena, const N values[], int size){
+	listNode<N>* head = nullptr;
+	listNode<N>* tail = nullptr;
+	for(int i = 0; i < size; i++){
+		listNode<N>* node = arena.allocate();
+		node->data = values[i];
+		if(tail)
+			tail->next = node;
+		else
+			head = node;
+		tail = node;
+	}
+	return head;
+}
+
+//builds a height balanced BST (parent pointers set) from sorted values with nodes from arena
+//O(n) time
+template<class V>
+treeNode<V>* buildBalancedBST(nodeArena<treeNode<V>>& arena, const V sorted[], int size, treeNode<V>* parent = nullptr){
+	if(size <= 0)
+		return nullptr;
+
+	int mid = size / 2;
+	treeNode<V>* node = arena.allocate();
+	node->data = sorted[mid];
+	node->parent = parent;
+	node->left = buildBalancedBST(arena, sorted, mid, node);
+	node->right = buildBalancedBST(arena, sorted + mid + 1, size - mid - 1, node);
+	return node;
+}
+
+//open addressing hash set with linear probing, keys and occupancy kept in flat arrays
+//used where a node based std::set would allocate once per element
+template<class K>
+class flatHashSet
+{
+public:
+	flatHashSet(size_t expected = 16){
+		size_t cap = 16;
+		while(cap < 2 * expected)
+			cap *= 2;
+		keys.resize(cap);
+		used.assign(cap, 0);
+	}
+
+	//inserts key, returns whether it was not already present
+	//O(1) expected time
+	bool insert(const K& key){
+		if(2 * (count + 1) > keys.size())
+			grow();
+		size_t mask = keys.size() - 1;
+		for(size_t i = slot(key); ; i = (i + 1) & mask){
+			if(!used[i]){
+				used[i] = 1;
+				keys[i] = key;
+				count++;
+				return true;
+			}
+			if(keys[i] == key)
+				return false;
+		}
+	}
+
+	//determines whether key is present
+	//O(1) expected time
+	bool contains(const K& key) const {
+		size_t mask = keys.size() - 1;
+		for(size_t i = slot(key); used[i]; i = (i + 1) & mask){
+			if(keys[i] == key)
+				return true;
+		}
+		return false;
+	}
+
+	size_t size() const { return count; }
+
+private:
+	// std::hash is often the identity for integers, so mix the bits before masking
+	size_t slot(const K& key) const {
+		unsigned long long h = hash<K>()(key);
+		h ^= h >> 33;
+		h *= 0xff51afd7ed558ccdULL;
+		h ^= h >> 33;
+		return (size_t)h & (keys.size() - 1);
+	}
+
+	void grow(){
+		vector<K> oldKeys;
+		vector<unsigned char> oldUsed;
+		oldKeys.swap(keys);
+		oldUsed.swap(used);
+		keys.resize(oldKeys.size() * 2);
+		used.assign(oldKeys.size() * 2, 0);
+		count = 0;
+		for(size_t i = 0; i < oldKeys.size(); i++){
+			if(oldUsed[i])
+				insert(oldKeys[i]);
+		}
+	}
+
+	vector<K> keys;
+	vector<unsigned char> used;
+	size_t count = 0;
+};
+
 /*
 * Strings
 */
@@ -51,6 +364,20 @@ void reverseString(char* begin, char* end);
 //O(n) time
 void reverseWords(char* str);
 
+//reverses size bytes starting at str in place (16 bytes at a time with SSSE3)
+//O(n) time
+void reverseBytes(char* str, size_t size);
+
+//reverses the order of space separated words in the first size bytes of str in place
+//word boundaries are found 16 bytes at a time with SSE2
+//O(n) time
+void reverseWords(char* str, size_t size);
+
+//removes spaces from the first size bytes of str in place and returns the new size
+//packs 16 bytes at a time with SSSE3 shuffles
+//O(n) time
+size_t removeSpaces(char* str, size_t size);
+
 //Checks whether string s1 and s2 are a rotation of each other
 bool isRotated(string s1, string s2);
 
@@ -62,6 +389,53 @@ bool isAnagram(string s1, string s2);
 //O(n) time
 string runLengthEncode(string s);
 
+//returns the length of the run of in[0] at the start of in (compares 32 bytes at a time with SSE2/AVX2)
+//O(run) time
+size_t runLength(const unsigned char* in, size_t size);
+
+//largest output rleEncoder can produce for size input bytes (including its pending run)
+size_t rleEncodeBound(size_t size);
+
+//binary-safe run length encoding, each run is stored as its byte followed by a varint count
+//O(n) time
+string rleEncode(const string& s);
+
+//decodes output of rleEncode into out, returns false on malformed input or if the output would exceed maxSize bytes
+//a few header bytes can describe an arbitrarily long run, so pass maxSize when decoding untrusted input
+//O(n) time
+bool rleDecode(const string& in, string& out, size_t maxSize = SIZE_MAX);
+
+//streaming run length encoder, runs may span chunk boundaries
+struct rleEncoder
+{
+	unsigned char value = 0;
+	unsigned long long count = 0;
+
+	//encodes size bytes of in, out must hold rleEncodeBound(size) bytes, returns bytes written
+	size_t update(const unsigned char* in, size_t size, unsigned char* out);
+
+	//writes the pending run (at most 11 bytes), returns bytes written
+	size_t finish(unsigned char* out);
+};
+
+//streaming run length decoder, runs and varints may span chunk boundaries
+struct rleDecoder
+{
+	unsigned char value = 0;
+	unsigned long long remaining = 0;
+	unsigned long long partial = 0;
+	int shift = 0;
+	bool inHeader = false;
+	bool failed = false;
+
+	//decodes from in until out holds outCap bytes or in is used up
+	//consumed is set to the number of input bytes used, returns bytes written
+	size_t update(const unsigned char* in, size_t size, size_t& consumed, unsigned char* out, size_t outCap);
+
+	//determines whether the stream ended on a run boundary without errors
+	bool done() const;
+};
+
 //inserts c at pos in s
 string insertCharAt(string s, char c, int pos);
 
@@ -71,6 +445,60 @@ int shortestDist(string s[], int size, string s1, string s2);
 //determines whether s can be rearranged to form a palindrome
 bool canFormPalindrome(string s);
 
+//computes palindrome radii of the first n bytes of s (Manacher's algorithm)
+//d1[i] = number of odd length palindromes centered at i
+//d2[i] = number of even length palindromes centered between i-1 and i
+//O(n) time, O(n) space
+void manacher(const char* s, size_t n, vector<int>& d1, vector<int>& d2);
+
+//returns the longest palindromic substring of s
+//O(n) time
+string longestPalindromicSubstr(const string& s);
+
+//counts the palindromic substrings of s (each occurrence counted separately)
+//O(n) time
+long long countPalindromicSubstrings(const string& s);
+
+//returns the maximal palindrome around every center of s as (start, length) pairs
+//odd centers come first, then even centers, empty palindromes are skipped
+//O(n) time
+vector<pair<int, int>> maximalPalindromes(const string& s);
+
+//palindromic tree (eertree) over a text that grows one character at a time
+//each node is a distinct palindrome, edges are kept in flat lists like suffixAutomaton
+struct palindromicTree
+{
+	string text;
+	vector<int> len;
+	vector<int> link;
+	vector<int> depth;
+	vector<int> firstEdge;
+	vector<int> edgeTo;
+	vector<int> edgeNext;
+	vector<unsigned char> edgeChar;
+	int last = 1;
+	long long total = 0;
+
+	palindromicTree();
+
+	//appends c to the text, returns whether it created a new distinct palindrome
+	//O(1) amortized time
+	bool add(char c);
+
+	//number of distinct non-empty palindromes in the text
+	int distinctPalindromes() const;
+
+	//number of palindromic substrings in the text (each occurrence counted separately)
+	long long palindromeCount() const;
+
+	//length of the longest palindrome ending at the last character
+	int longestSuffixPalindrome() const;
+
+private:
+	int findSuffix(int node, int pos) const;
+	int transition(int node, unsigned char c) const;
+};
+
 //returns the next lexicographically greater string than s
 string nextPermutation(string s);
 
@@ -94,6 +522,107 @@ bool isIsomorphic(const string& s1, const string& s2);
 //O(n) time
 int maxValidSubstring(const string& s);
 
+//builds the suffix array of s using SA-IS (induced sorting)
+//O(n) time
+vector<int> buildSuffixArray(const string& s);
+
+//builds the longest common prefix array of s from its suffix array (Kasai's algorithm)
+//lcp[i] is the length of the common prefix of suffixes sa[i-1] and sa[i], lcp[0] = 0
+//O(n) time
+vector<int> buildLCPArray(const string& s, const vector<int>& sa);
+
+//returns the longest substring that occurs at least twice in s
+//O(n) time
+string longestRepeatedSubstr(const string& s);
+
+//counts the distinct non-empty substrings of s
+//O(n) time
+long long countDistinctSubstrings(const string& s);
+
+//suffix array + LCP index over a fixed text, built once and queried many times
+struct suffixArrayIndex
+{
+	string text;
+	vector<int> sa;
+	vector<int> lcp;
+
+	suffixArrayIndex() {}
+	suffixArrayIndex(const string& s);
+
+	//counts occurrences of p in the text
+	//O(m log n) time, m = size of p
+	int countOccurrences(const string& p) const;
+
+	//compact binary form of the index
+	string serialize() const;
+
+	//rebuilds an index written by serialize into index, returns false (leaving index unchanged) for malformed data
+	//sa must sort the text's suffixes and lcp must match, both are verified
+	//O(n) time
+	static bool deserialize(const string& data, suffixArrayIndex& index);
+};
+
+//suffix automaton (smallest DFA accepting every substring) over a fixed text
+//transitions are kept in flat edge lists so large corpora stay compact; a state with denseEdges or more edges
+//also gets a 256 entry table from character to edge, so following a transition scans fewer than denseEdges
+//edges and queries cost O(1) per character
+struct suffixAutomaton
+{
+	vector<int> len;
+	vector<int> link;
+	vector<int> occ;
+	vector<int> firstEdge;
+	vector<int> edgeTo;
+	vector<int> edgeNext;
+	vector<unsigned char> edgeChar;
+	int last = 0;
+
+	suffixAutomaton();
+
+	//builds the automaton of s
+	//O(n) time
+	suffixAutomaton(const string& s);
+
+	//determines whether p is a substring of the text
+	//O(m) time
+	bool contains(const string& p) const;
+
+	//counts occurrences of p in the text
+	//O(m) time
+	int countOccurrences(const string& p) const;
+
+	//returns the length of the longest common substring of the text and t
+	//O(m) time
+	int longestCommonSubstr(const string& t) const;
+
+	//counts the distinct non-empty substrings of the text
+	//O(states) time
+	long long countDistinctSubstrings() const;
+
+	//compact binary form of the automaton
+	string serialize() const;
+
+	//rebuilds an automaton written by serialize into sam, returns false (leaving sam unchanged) for malformed data
+	//links, edge indices and edge targets are range checked and edge lists must be acyclic
+	//O(states + edges) time
+	static bool deserialize(const string& data, suffixAutomaton& sam);
+
+	static const int denseEdges = 8;
+
+private:
+	int findEdge(int state, unsigned char c) const;
+	int transition(int state, unsigned char c) const;
+	void addState(int length, int suffixLink, int count);
+	void addEdge(int state, int to, unsigned char c);
+	void makeDense(int state);
+	void extend(unsigned char c);
+
+	//derived from the edge lists, not serialized: edge counts, and for dense states their table in denseEdge
+	vector<int> degree;
+	vector<int> denseSlot;
+	vector<int> denseEdge;
+};
+
 /*
 * Arrays
 */
@@ -164,126 +693,2999 @@ bool isHeap(int a[], int i, int n);
 * Linked Lists
 */
 
-//Reverse a linked list
+//list templates are defined here rather than in algorithms.cpp so they can be instantiated for any payload type
+//all of them are iterative, use O(1) stack and return the (possibly new) head where the list changes shape
+
+//Reverse a linked list, returns the new head
 //O(n) time, O(1) space
 template<class N>
-void reverseLinkedList(listNode* head);
-
-//removes duplicates from an unsorted linked list
+listNode<N>* reverseLinkedList(listNode<N>* head){
+	listNode<N>* prev = nullptr;
+	listNode<N>* curr = head;
+	listNode<N>* next;
+
+	while(curr){
+		next = curr->next;
+		curr->next = prev;
+		prev = curr;
+		curr = next;
+	}
+	return prev;
+}
+
+//returns the number of nodes in a list
 //O(n) time
 template<class N>
-void removeDuplicates(listNode* node);
+size_t listLength(listNode<N>* head){
+	size_t len = 0;
+	for(; head != nullptr; head = head->next)
+		len++;
+	return len;
+}
+
+//removes duplicates from an unsorted linked list, keeping first occurrences, returns the head
+//unlinked nodes are not freed since the caller owns them
+//O(n) expected time, flat hash set of about 2n keys
+template<class N>
+listNode<N>* removeDuplicates(listNode<N>* head){
+	flatHashSet<N> listData(listLength(head));
+	listNode<N>* prev = nullptr;
+	listNode<N>* node = head;
+
+	while(node != nullptr){
+		if(!listData.insert(node->data))
+			prev->next = node->next;
+		else
+			prev = node;
+		node = node->next;
+	}
+	return head;
+}
+
+//removes duplicates from a list of integers known to lie in [minKey, maxKey], keeping first occurrences
+//values outside the range are kept as they are
+//keys are tracked in a bitmap, or in a flat hash set when the range is much larger than the list
+//O(n + min(range, n)) time
+template<class N>
+listNode<N>* removeDuplicatesBounded(listNode<N>* head, N minKey, N maxKey){
+	if(maxKey < minKey)
+		return head;
+
+	// offsets are taken in the unsigned type so maxKey - minKey can't overflow for signed N
+	typedef typename make_unsigned<N>::type key;
+	key range = (key)maxKey - (key)minKey;
+	size_t length = listLength(head);
+	bool bitmap = range / 64 <= length + 1024;
+	vector<unsigned long long> seen(bitmap ? (size_t)(range / 64) + 1 : 0, 0);
+	flatHashSet<N> hashed(bitmap ? 0 : length);
+
+	listNode<N>* prev = nullptr;
+	listNode<N>* node = head;
+	while(node != nullptr){
+		if(node->data >= minKey && node->data <= maxKey){
+			bool repeat;
+			if(bitmap){
+				key bit = (key)node->data - (key)minKey;
+				unsigned long long mask = 1ULL << (bit & 63);
+				repeat = (seen[bit >> 6] & mask) != 0;
+				seen[bit >> 6] |= mask;
+			}
+			else
+				repeat = !hashed.insert(node->data);
+
+			if(repeat){
+				prev->next = node->next;
+				node = node->next;
+				continue;
+			}
+		}
+		prev = node;
+		node = node->next;
+	}
+	return head;
+}
+
+//merges two sorted lists into one, taking from a first on ties, returns the new head
+//O(n+m) time, O(1) space
+template<class N>
+listNode<N>* mergeSortedLists(listNode<N>* a, listNode<N>* b){
+	listNode<N> dummy;
+	listNode<N>* tail = &dummy;
+	while(a != nullptr && b != nullptr){
+		if(b->data < a->data){
+			tail->next = b;
+			b = b->next;
+		}
+		else{
+			tail->next = a;
+			a = a->next;
+		}
+		tail = tail->next;
+	}
+	tail->next = (a != nullptr) ? a : b;
+	return dummy.next;
+}
+
+//sorts a list with bottom-up merge sort (stable), returns the new head
+//bins[i] holds a sorted run of 2^i nodes, so small merges happen while their nodes are still in cache
+//O(n log n) time, O(1) space
+template<class N>
+listNode<N>* sortList(listNode<N>* head){
+	listNode<N>* bins[64] = { nullptr };
+
+	while(head != nullptr){
+		listNode<N>* carry = head;
+		head = head->next;
+		carry->next = nullptr;
+
+		//binary counter: merge equal sized runs until an empty bin is found
+		int i = 0;
+		for(; i < 63 && bins[i] != nullptr; i++){
+			carry = mergeSortedLists(bins[i], carry);
+			bins[i] = nullptr;
+		}
+		bins[i] = carry;
+	}
+
+	//higher bins hold earlier nodes, merge them in front to keep the sort stable
+	listNode<N>* res = nullptr;
+	for(int i = 0; i < 64; i++){
+		if(bins[i] != nullptr)
+			res = mergeSortedLists(bins[i], res);
+	}
+	return res;
+}
+
+//sorts a list and removes duplicates, returns the new head (list order is not kept)
+//O(n log n) time, O(1) space
+template<class N>
+listNode<N>* removeDuplicatesSorted(listNode<N>* head){
+	head = sortList(head);
+	for(listNode<N>* node = head; node != nullptr; ){
+		if(node->next != nullptr && !(node->data < node->next->data))
+			node->next = node->next->next;
+		else
+			node = node->next;
+	}
+	return head;
+}
 
 //finds the kth to last element of a singly linked list
 //O(n) time
 template<class N>
-listNode* kthToLastOfList(listNode* head, int k);
+listNode<N>* kthToLastOfList(listNode<N>* head, int k){
+	if(k <= 0) 
+		return nullptr;
+
+	listNode<N>* r1 = head;
+	listNode<N>* r2 = head;
+
+	//move r2 k-1 nodes ahead of r1
+	for(int i = 0; i < k-1; i++){
+		if(r2 == nullptr)
+			return nullptr;
+		r2 = r2->next;
+	}
+	if(r2 == nullptr)
+		return nullptr;
+
+	while(r2->next != nullptr){
+		r1 = r1->next;
+		r2 = r2->next;
+	}
+	return r1;
+}
 
 //deletes a node in the middle of a singly linked list, given only access to that node
+//the unlinked successor is not freed since the caller owns it
 template<class N>
-bool deleteListNode(listNode* node);
-
-//finds beginning of loop in a circular linked list
+bool deleteListNode(listNode<N>* node){
+	if(node == nullptr || node->next == nullptr)
+		return false;
+
+	//copies next node's data to current node and unlinks next node
+	listNode<N>* next = node->next;
+	node->data = next->data;
+	node->next = next->next;
+	return true;
+}
+
+//finds beginning of loop in a circular linked list, nullptr if there is no loop
+//O(n) time, O(1) space
 template<class N>
-listNode* findBegin(listNode* head);
+listNode<N>* findBegin(listNode<N>* head){
+	listNode<N>* slow = head;
+	listNode<N>* fast = head;
+
+	//slow travels 1 node while fast travels 2 nodes at a time
+	//when they collide, break and set slow to head
+	while(fast != nullptr && fast->next != nullptr){
+		slow = slow->next;
+		fast = fast->next->next;
+		if(slow == fast)
+			break;
+	}
+
+	if(fast == nullptr || fast->next == nullptr)
+		return nullptr;
+	
+	slow = head;
+	
+	//both slow and fast travel 1 node at a time and when they collide, they're at the beginning of the loop in the list
+	while(slow != fast){
+		slow = slow->next;
+		fast = fast->next;
+	}
+	return fast;
+}
+
+//finds intersection point of two singly linked lists, nullptr if they don't intersect
+//skips the extra nodes of the longer list so both walks reach the intersection together
+//O(n+m) time, O(1) space, n and m are sizes of the linked lists
+template<class N>
+listNode<N>* findIntersection(listNode<N>* h1, listNode<N>* h2){
+	size_t len1 = listLength(h1);
+	size_t len2 = listLength(h2);
+
+	for(; len1 > len2; len1--)
+		h1 = h1->next;
+	for(; len2 > len1; len2--)
+		h2 = h2->next;
+
+	while(h1 != h2){
+		h1 = h1->next;
+		h2 = h2->next;
+	}
+	return h1;
+}
+
+//keeps k uniform samples of a stream of unknown length (reservoir sampling, Algorithm L)
+//once the reservoir is full it draws how many items to skip, so RNG calls grow as O(k log(n/k))
+//each thread should fill its own sampler and combine them with merge()
+template<class T, class RNG = mt19937_64>
+class reservoirSampler
+{
+public:
+	reservoirSampler(size_t k, unsigned long long seed = random_device{}()) : k(k), rng(seed) {
+		items.reserve(k);
+	}
+
+	//offers item to the reservoir
+	//O(1) time
+	void push(const T& item){
+		if(items.size() < k){
+			items.push_back(item);
+			count++;
+			if(items.size() == k)
+				startSkipping();
+			return;
+		}
+		if(k == 0){
+			count++;
+			return;
+		}
+		if(count == nextPick){
+			items[uniform_int_distribution<size_t>(0, k-1)(rng)] = item;
+			w *= exp(log(uniform()) / k);
+			drawNextPick();
+		}
+		count++;
+	}
+
+	//number of upcoming items that will be rejected without looking at them
+	unsigned long long toSkip() const {
+		if(items.size() < k || k == 0)
+			return 0;
+		return nextPick - count;
+	}
+
+	//passes over n items that toSkip() said would be rejected
+	void skip(unsigned long long n){
+		count += n;
+	}
+
+	//offers every item in [first, last), jumping over rejected items with std::advance
+	//O(n) iterator steps for forward iterators, O(k log(n/k)) for random access ones
+	template<class It>
+	void pushRange(It first, It last){
+		unsigned long long left = distance(first, last);
+		while(left > 0){
+			unsigned long long jump = min(toSkip(), left);
+			if(jump > 0){
+				advance(first, jump);
+				skip(jump);
+				left -= jump;
+				continue;
+			}
+			push(*first);
+			++first;
+			left--;
+		}
+	}
+
+	//adds the samples of a reservoir filled from a disjoint stream, as if both streams went through this one
+	//O(k) time
+	void merge(const reservoirSampler& other){
+		vector<T> mine(items);
+		vector<T> theirs(other.items);
+		unsigned long long leftMine = count;
+		unsigned long long leftTheirs = other.count;
+		size_t want = min((unsigned long long)k, leftMine + leftTheirs);
+
+		//draw without replacement from the union, choosing a side by its remaining population
+		items.clear();
+		while(items.size() < want){
+			vector<T>& side = (uniform_int_distribution<unsigned long long>(1, leftMine + leftTheirs)(rng) <= leftMine) ? mine : theirs;
+			size_t pick = uniform_int_distribution<size_t>(0, side.size()-1)(rng);
+			items.push_back(side[pick]);
+			side[pick] = side.back();
+			side.pop_back();
+			if(&side == &mine)
+				leftMine--;
+			else
+				leftTheirs--;
+		}
+		count += other.count;
+
+		//restart skipping from a fresh draw of the kth smallest of count uniforms, Beta(k, count-k+1)
+		if(items.size() == k && k > 0){
+			double x = gamma_distribution<double>((double)k, 1.0)(rng);
+			double y = gamma_distribution<double>((double)(count - k + 1), 1.0)(rng);
+			w = x / (x + y);
+			nextPick = count - 1;
+			drawNextPick();
+		}
+	}
+
+	//the current samples (fewer than k if fewer items were seen)
+	const vector<T>& samples() const { return items; }
+
+	//number of items offered so far
+	unsigned long long seen() const { return count; }
+
+private:
+	// uniform in (0, 1)
+	double uniform(){
+		double u;
+		do{
+			u = generate_canonical<double, 53>(rng);
+		}while(u <= 0.0);
+		return u;
+	}
+
+	void startSkipping(){
+		w = exp(log(uniform()) / k);
+		nextPick = count - 1;
+		drawNextPick();
+	}
+
+	// geometric jump to the index of the next accepted item
+	void drawNextPick(){
+		double jump = floor(log(uniform()) / log1p(-w));
+		if(!(jump < 1e18))
+			jump = 1e18;
+		nextPick += (unsigned long long)jump + 1;
+	}
+
+	size_t k;
+	vector<T> items;
+	unsigned long long count = 0;
+	unsigned long long nextPick = 0;
+	double w = 0.0;
+	RNG rng;
+};
 
-//creates a linked list for all the nodes at the level specified
-template<class V>
-void createLevelLinkedList(treeNode* root, listNode* head, int level);
+//keeps k samples of a weighted stream where each item's inclusion follows its weight (A-ExpJ)
+//after the reservoir fills it jumps over items by accumulated weight, so RNG calls grow as O(k log(n/k))
+//reservoirs from disjoint streams combine exactly with merge()
+template<class T, class RNG = mt19937_64>
+class weightedReservoirSampler
+{
+public:
+	weightedReservoirSampler(size_t k, unsigned long long seed = random_device{}()) : k(k), rng(seed) {
+		heap.reserve(k);
+	}
+
+	//offers item with weight (items with weight <= 0 are never picked)
+	//O(log k) time when accepted, O(1) otherwise
+	void push(const T& item, double weight){
+		if(k == 0 || !(weight > 0.0))
+			return;
+
+		//fill phase: key = log(u) / weight
+		if(heap.size() < k){
+			insert(log(uniform()) / weight, item);
+			if(heap.size() == k)
+				drawJump();
+			return;
+		}
+
+		skipped += weight;
+		if(skipped < jump)
+			return;
+
+		//item enters with a key above the current minimum
+		double minKey = heap.front().first;
+		double t = exp(weight * minKey);
+		double r = t + (1.0 - t) * uniform();
+		pop_heap(heap.begin(), heap.end(), greaterKey);
+		heap.back() = make_pair(log(r) / weight, item);
+		push_heap(heap.begin(), heap.end(), greaterKey);
+		drawJump();
+	}
+
+	//adds the samples of a reservoir filled from a disjoint stream
+	//O(k log k) time
+	void merge(const weightedReservoirSampler& other){
+		for(size_t i = 0; i < other.heap.size(); i++){
+			if(heap.size() < k)
+				insert(other.heap[i].first, other.heap[i].second);
+			else if(k > 0 && other.heap[i].first > heap.front().first){
+				pop_heap(heap.begin(), heap.end(), greaterKey);
+				heap.back() = other.heap[i];
+				push_heap(heap.begin(), heap.end(), greaterKey);
+			}
+		}
+		if(heap.size() == k && k > 0)
+			drawJump();
+	}
+
+	//the current samples in no particular order
+	vector<T> samples() const {
+		vector<T> res;
+		res.reserve(heap.size());
+		for(size_t i = 0; i < heap.size(); i++)
+			res.push_back(heap[i].second);
+		return res;
+	}
+
+private:
+	static bool greaterKey(const pair<double, T>& a, const pair<double, T>& b){
+		return a.first > b.first;
+	}
+
+	double uniform(){
+		double u;
+		do{
+			u = generate_canonical<double, 53>(rng);
+		}while(u <= 0.0);
+		return u;
+	}
+
+	void insert(double key, const T& item){
+		heap.push_back(make_pair(key, item));
+		push_heap(heap.begin(), heap.end(), greaterKey);
+	}
+
+	// weight to pass over before the next item is accepted
+	void drawJump(){
+		jump = log(uniform()) / heap.front().first;
+		skipped = 0.0;
+	}
+
+	size_t k;
+	vector<pair<double, T>> heap;
+	double jump = 0.0;
+	double skipped = 0.0;
+	RNG rng;
+};
 
-//finds intersection point of two singly linked lists
-//O(n+m) time, n and m are sizes of the linked lists
+//draws k uniform samples from a list, walking over rejected nodes without calling the RNG
+//O(n) time, O(k log(n/k)) random draws
+template<class N, class RNG>
+vector<N> sampleList(listNode<N>* head, size_t k, RNG& rng){
+	reservoirSampler<N> sampler(k, rng());
+	while(head != nullptr){
+		unsigned long long jump = sampler.toSkip();
+		unsigned long long moved = 0;
+		for(; moved < jump && head != nullptr; moved++)
+			head = head->next;
+		sampler.skip(moved);
+		if(head == nullptr)
+			break;
+		sampler.push(head->data);
+		head = head->next;
+	}
+	return sampler.samples();
+}
+
+//returns a random node from a list, nullptr if the list is empty
+//uses reservoir sampling with skips and a per-thread generator seeded once
+//O(n) time, O(log n) random draws, O(1) space
 template<class N>
-int findIntersection(listNode* h1, listNode* h2);
-
-//returns a random number from a list
-//uses reservoir sampling technique
+listNode<N>* findRandom(listNode<N>* head){
+	static thread_local mt19937_64 rng(random_device{}());
+
+	reservoirSampler<listNode<N>*> sampler(1, rng());
+	while(head != nullptr){
+		for(unsigned long long jump = sampler.toSkip(); jump > 0 && head != nullptr; jump--){
+			head = head->next;
+			sampler.skip(1);
+		}
+		if(head == nullptr)
+			break;
+		sampler.push(head);
+		head = head->next;
+	}
+	return sampler.samples().empty() ? nullptr : sampler.samples()[0];
+}
+
+//reverse a singly linked list in groups of k nodes, returns the new head
+//O(n) time, O(1) space
 template<class N>
-int findRandom(listNode* head);
-
-//reverse a singly linked list in groups of k nodes
-//O(n) time
+listNode<N>* reverseListByK(listNode<N>* head, int k){
+	if(k <= 1)
+		return head;
+
+	listNode<N>* newHead = nullptr;
+	//last node of the previous reversed group
+	listNode<N>* prevTail = nullptr;
+	listNode<N>* curr = head;
+
+	while(curr != nullptr){
+		//reverse next k nodes, groupHead becomes the group's tail
+		listNode<N>* groupHead = curr;
+		listNode<N>* prev = nullptr;
+		for(int count = 0; curr != nullptr && count < k; count++){
+			listNode<N>* next = curr->next;
+			curr->next = prev;
+			prev = curr;
+			curr = next;
+		}
+
+		//attach reversed group after the previous one
+		if(prevTail)
+			prevTail->next = prev;
+		else
+			newHead = prev;
+		prevTail = groupHead;
+	}
+	return newHead;
+}
+
+//unrolled linked list, each block stores many elements so a traversal costs one miss per block instead of per element
+//blocks are never empty, N must be default constructible and copyable
 template<class N>
-void reverseListByK(listNode* head, int k);
+class unrolledList
+{
+	static const int blockBytes = 256;
+	static const int capacity = (blockBytes - 2 * (int)sizeof(void*)) / (int)sizeof(N) > 0 ?
+		(blockBytes - 2 * (int)sizeof(void*)) / (int)sizeof(N) : 1;
+
+	struct block
+	{
+		block* next;
+		int count;
+		N items[capacity];
+	};
+
+public:
+	//forward iterator over the elements
+	class iterator
+	{
+	public:
+		typedef forward_iterator_tag iterator_category;
+		typedef N value_type;
+		typedef ptrdiff_t difference_type;
+		typedef N* pointer;
+		typedef N& reference;
+
+		iterator(block* b, int i) : b(b), i(i) {}
+		N& operator*() const { return b->items[i]; }
+		N* operator->() const { return &b->items[i]; }
+		iterator& operator++(){
+			if(++i == b->count){
+				b = b->next;
+				i = 0;
+			}
+			return *this;
+		}
+		bool operator==(const iterator& o) const { return b == o.b && i == o.i; }
+		bool operator!=(const iterator& o) const { return !(*this == o); }
+
+	private:
+		block* b;
+		int i;
+	};
+
+	unrolledList() {}
+	~unrolledList() { clear(); }
+	unrolledList(const unrolledList&) = delete;
+	unrolledList& operator=(const unrolledList&) = delete;
+
+	iterator begin() const { return iterator(head, 0); }
+	iterator end() const { return iterator(nullptr, 0); }
+	size_t size() const { return count; }
+	bool empty() const { return count == 0; }
+
+	//appends value
+	//O(1) time
+	void push_back(const N& value){
+		if(tail == nullptr || tail->count == capacity){
+			block* b = newBlock();
+			if(tail)
+				tail->next = b;
+			else
+				head = b;
+			tail = b;
+		}
+		tail->items[tail->count++] = value;
+		count++;
+	}
+
+	//prepends value
+	//O(block size) time
+	void push_front(const N& value){
+		if(head == nullptr || head->count == capacity){
+			block* b = newBlock();
+			b->next = head;
+			head = b;
+			if(tail == nullptr)
+				tail = b;
+		}
+		for(int i = head->count; i > 0; i--)
+			head->items[i] = head->items[i-1];
+		head->items[0] = value;
+		head->count++;
+		count++;
+	}
+
+	//frees every block
+	//O(n / block size) time
+	void clear(){
+		while(head){
+			block* next = head->next;
+			delete head;
+			head = next;
+		}
+		tail = nullptr;
+		count = 0;
+	}
+
+	//packs elements so every block but the last is full
+	//O(n) time
+	void compact(){
+		keepIf([](const N&){ return true; });
+	}
+
+	//reverses the list by reversing the block chain and the elements inside each block
+	//O(n) time, O(1) space
+	void reverse(){
+		block* prev = nullptr;
+		block* curr = head;
+		tail = head;
+		while(curr){
+			std::reverse(curr->items, curr->items + curr->count);
+			block* next = curr->next;
+			curr->next = prev;
+			prev = curr;
+			curr = next;
+		}
+		head = prev;
+	}
+
+	//reverses the list in groups of k elements (a shorter last group is reversed too)
+	//O(n) time, O(n / block size) space
+	void reverseByK(int k){
+		if(k <= 1 || count < 2)
+			return;
+
+		// once packed, element i sits at blocks[i / capacity]->items[i % capacity]
+		compact();
+		vector<block*> blocks;
+		blocks.reserve(count / capacity + 1);
+		for(block* b = head; b; b = b->next)
+			blocks.push_back(b);
+
+		for(size_t start = 0; start < count; start += k){
+			size_t lo = start;
+			size_t hi = min(start + k, count) - 1;
+			while(lo < hi){
+				std::swap(blocks[lo / capacity]->items[lo % capacity], blocks[hi / capacity]->items[hi % capacity]);
+				lo++;
+				hi--;
+			}
+		}
+	}
+
+	//returns the kth to last element, or nullptr if k is out of range
+	//O(n / block size) time
+	N* kthToLast(size_t k) const {
+		if(k == 0 || k > count)
+			return nullptr;
+
+		// skip whole blocks until the one holding index count-k
+		size_t index = count - k;
+		block* b = head;
+		while(index >= (size_t)b->count){
+			index -= b->count;
+			b = b->next;
+		}
+		return &b->items[index];
+	}
+
+	//removes repeated values, keeping the first occurrence of each
+	//O(n) time expected
+	void removeDuplicates(){
+		flatHashSet<N> seen(count);
+		keepIf([&seen](const N& value){ return seen.insert(value); });
+	}
+
+	//returns a uniformly random element, or nullptr if the list is empty
+	//O(n / block size) time
+	template<class RNG>
+	N* randomElement(RNG& rng) const {
+		if(count == 0)
+			return nullptr;
+		uniform_int_distribution<size_t> pick(1, count);
+		return kthToLast(pick(rng));
+	}
+
+private:
+	block* newBlock(){
+		block* b = new block();
+		b->next = nullptr;
+		b->count = 0;
+		return b;
+	}
+
+	// keeps elements for which keep returns true, packing them forward block by block
+	// the write position never passes the read position so this works in place
+	template<class Pred>
+	void keepIf(Pred keep){
+		if(head == nullptr)
+			return;
+
+		block* wb = head;
+		int wi = 0;
+		size_t kept = 0;
+		for(block* rb = head; rb; rb = rb->next){
+			for(int i = 0; i < rb->count; i++){
+				if(!keep(rb->items[i]))
+					continue;
+				if(wi == capacity){
+					wb->count = capacity;
+					wb = wb->next;
+					wi = 0;
+				}
+				wb->items[wi++] = rb->items[i];
+				kept++;
+			}
+		}
+
+		// free the blocks left over after the write position
+		block* extra = wb->next;
+		wb->next = nullptr;
+		wb->count = wi;
+		while(extra){
+			block* next = extra->next;
+			delete extra;
+			extra = next;
+		}
+		tail = wb;
+		count = kept;
+		if(wi == 0)
+			clear();
+	}
+
+	block* head = nullptr;
+	block* tail = nullptr;
+	size_t count = 0;
+};
 
 /*
 * Graphs
 */
 
-//determines whether n1 and n2 are connected within the graph
+//determines whether n2 is reachable from n1 within the graph
+//keeps its own visited set, so visited flags are left alone and repeated calls give the same answer
+//O(n + m) time, use buildCSR and bfsEngine for many queries on one graph
+template<class G>
+bool isConnected(graphNode<G>* n1, graphNode<G>* n2){
+	if(n1 == n2)
+		return true;
+
+	//visited set is local, so the nodes' visited flags stay untouched
+	flatHashSet<graphNode<G>*> visited;
+	vector<graphNode<G>*> nodes(1, n1);
+	visited.insert(n1);
+
+	for(size_t head = 0; head < nodes.size(); head++){
+		for(graphNode<G>* i : nodes[head]->connectedTo){
+			if(i == n2)
+				return true;
+			if(visited.insert(i))
+				nodes.push_back(i);
+		}
+	}
+	return false;
+}
+
+//fixed size set of vertex ids kept outside the graph, so several traversals can run on one graph
+//set and test are plain, trySet is atomic so threads can claim vertices concurrently
+class vertexBitset
+{
+public:
+	vertexBitset(size_t n = 0) : words((n + 63) / 64), bits(n) {}
+	vertexBitset(const vertexBitset&) = delete;
+	vertexBitset& operator=(const vertexBitset&) = delete;
+
+	size_t size() const { return bits; }
+
+	bool test(uint32_t v) const{
+		return (words[v >> 6].load(memory_order_relaxed) >> (v & 63)) & 1;
+	}
+
+	void set(uint32_t v){
+		words[v >> 6].store(words[v >> 6].load(memory_order_relaxed) | (1ULL << (v & 63)), memory_order_relaxed);
+	}
+
+	//sets v atomically, returns whether this call set it
+	bool trySet(uint32_t v){
+		uint64_t bit = 1ULL << (v & 63);
+		if(words[v >> 6].load(memory_order_relaxed) & bit)
+			return false;
+		return !(words[v >> 6].fetch_or(bit, memory_order_relaxed) & bit);
+	}
+
+	//64 bits starting at vertex 64 * i
+	uint64_t word(size_t i) const{
+		return words[i].load(memory_order_relaxed);
+	}
+
+	size_t wordCount() const{
+		return words.size();
+	}
+
+	//clears every bit
+	//O(n / 64) time
+	void clear();
+
+	//number of set bits
+	//O(n / 64) time
+	size_t count() const;
+
+private:
+	vector<atomic<uint64_t>> words;
+	size_t bits;
+};
+
+//edge with a non-negative integer weight for weighted csrGraphs
+struct weightedEdge
+{
+	uint32_t from;
+	uint32_t to;
+	uint32_t weight;
+};
+
+//immutable graph in compressed sparse row form: the neighbors of v are targets[offsets[v] ... offsets[v+1]-1]
+//4 bytes per edge plus 8 per vertex (another 4 per edge if weighted), every neighbor list is contiguous and sorted
+//vertices are numbered 0 ... n-1, traversal state lives in vertexBitsets rather than the graph
+//the arrays are either owned or a read-only view of a mapped file (see mapFile), the accessors work the same on both
+class csrGraph
+{
+public:
+	csrGraph() : offsets(1, 0) { bind(); }
+	csrGraph(const csrGraph& other);
+	csrGraph& operator=(const csrGraph& other);
+	//moving leaves other an empty graph
+	csrGraph(csrGraph&& other);
+	csrGraph& operator=(csrGraph&& other);
+
+	//builds a graph with n vertices from (from, to) edges, both directions are stored if undirected
+	//O(n + m log d) time, d = maximum degree
+	static csrGraph fromEdges(uint32_t n, const vector<pair<uint32_t, uint32_t>>& edges, bool undirected = false);
+
+	//builds a weighted graph, weights[e] is the weight of the edge stored at targets[e]
+	//O(n + m log d) time, d = maximum degree
+	static csrGraph fromWeightedEdges(uint32_t n, const vector<weightedEdge>& edges, bool undirected = false);
+
+	//writes the graph in the csr file format: a 64 byte header followed by the offsets, targets and (if weighted)
+	//weights arrays, each starting on a 64 byte boundary, in native byte order
+	//returns false if the file could not be written
+	//O(n + m) time
+	bool writeFile(const char* path) const;
+
+	//opens a file written by writeFile without parsing it: the file is mapped read-only and g points into it
+	//the mapping lives as long as g or any copy of it, returns false (leaving g unchanged) if the file is missing,
+	//truncated, from a machine with a different byte order, or its header describes sections that overlap or
+	//run past the end of the file
+	//the array contents are trusted, not validated: only offsets[0] and offsets[n] are read, so call validate()
+	//before traversing a file that may be corrupt or hostile
+	//O(1) time, pages are loaded by the OS on first access; falls back to reading the file where mmap is unavailable
+	static bool mapFile(const char* path, csrGraph& g);
+
+	//checks that offsets never decrease and end at edgeCount(), every target is below vertexCount()
+	//and every neighbor list is sorted, which is everything the accessors and algorithms rely on
+	//O(n + m) time
+	bool validate() const;
+
+	//whether the arrays are a view of a mapped file
+	bool isMapped() const { return mapping != nullptr; }
+
+	uint32_t vertexCount() const { return n; }
+	uint64_t edgeCount() const { return m; }
+	uint32_t degree(uint32_t v) const { return (uint32_t)(offsetData[v + 1] - offsetData[v]); }
+
+	//neighbors of v as a contiguous range
+	const uint32_t* neighborsBegin(uint32_t v) const { return targetData + offsetData[v]; }
+	const uint32_t* neighborsEnd(uint32_t v) const { return targetData + offsetData[v + 1]; }
+
+	//determines whether the edge (from, to) exists
+	//O(log d) time
+	bool hasEdge(uint32_t from, uint32_t to) const;
+
+	//graph with every edge reversed (weights follow their edges), identical to *this for undirected graphs
+	//O(n + m) time
+	csrGraph transpose() const;
+
+	//graph with vertex v renamed newId[v], newId must be a permutation of 0 ... n-1 (weights follow their edges)
+	//O(n + m log d) time
+	csrGraph relabel(const vector<uint32_t>& newId) const;
+
+	//edges of v are the indices edgesBegin(v) ... edgesEnd(v)-1 into targets and weights
+	uint64_t edgesBegin(uint32_t v) const { return offsetData[v]; }
+	uint64_t edgesEnd(uint32_t v) const { return offsetData[v + 1]; }
+	uint32_t edgeTarget(uint64_t e) const { return targetData[e]; }
+
+	//weight of edge e, 1 for unweighted graphs
+	uint32_t edgeWeight(uint64_t e) const { return weightData ? weightData[e] : 1; }
+	bool hasWeights() const { return weightData != nullptr; }
+
+	//raw arrays, offsets has vertexCount() + 1 entries, weights is nullptr for unweighted graphs
+	const uint64_t* offsetArray() const { return offsetData; }
+	const uint32_t* targetArray() const { return targetData; }
+	const uint32_t* weightArray() const { return weightData; }
+
+private:
+	//points the accessors at the owned vectors
+	void bind();
+
+	//drops the arrays (or mapping), leaving an empty graph
+	void reset();
+
+	vector<uint64_t> offsets;
+	vector<uint32_t> targets;
+	vector<uint32_t> weights;
+
+	const uint64_t* offsetData = nullptr;
+	const uint32_t* targetData = nullptr;
+	const uint32_t* weightData = nullptr;
+	uint32_t n = 0;
+	uint64_t m = 0;
+	//keeps a mapped file alive while any graph views it
+	shared_ptr<const void> mapping;
+};
+
+//breadth first search engine over a csrGraph and its transpose (pass the same graph twice if undirected)
+//search state belongs to the engine, not the graph, and resets in O(1) between queries
+//use one engine per querying thread, distances() spreads a single search over several threads itself
+class bfsEngine
+{
+public:
+	bfsEngine(const csrGraph& out, const csrGraph& in);
+	bfsEngine(const bfsEngine&) = delete;
+	bfsEngine& operator=(const bfsEngine&) = delete;
+
+	//hop distances from source, -1 where unreachable
+	//direction optimizing: levels expand top down from a frontier list while it is small and switch to
+	//bottom up (unvisited vertices look for a parent in a frontier bitmap) once the frontier's edges
+	//outnumber the unexplored ones / 14, switching back when the frontier drops below n / 24
+	//O(n + m) time
+	vector<int> distances(uint32_t source, unsigned threads = 0);
+
+	//determines whether target is reachable from source
+	//bidirectional: forward from source and backward from target, always growing the side with fewer edges to scan
+	//O(n + m) time worst case, usually far less
+	bool reachable(uint32_t source, uint32_t target);
+
+	//hop distance from source to target, -1 if unreachable, bidirectional like reachable
+	int distance(uint32_t source, uint32_t target);
+
+private:
+	//visited marks are stamps of the current query, so starting a query is just a new stamp
+	void newQuery();
+	int search(uint32_t source, uint32_t target, bool anyPath);
+
+	const csrGraph& out;
+	const csrGraph& in;
+	vector<uint32_t> stamp;
+	vector<uint32_t> depth;
+	uint32_t query = 0;
+	vector<uint32_t> forward, backward, next;
+};
+
+//numbers graphNode adjacency for the builders below, vertex i is nodes[i], and returns its edges as (from, to) ids
+//neighbors missing from nodes are appended to it, so passing just a start node captures everything reachable from it
+//visited flags are not read or written
+//O(n + m) expected time
+template<class G>
+vector<pair<uint32_t, uint32_t>> assignIds(vector<graphNode<G>*>& nodes){
+	unordered_map<graphNode<G>*, uint32_t> ids;
+	ids.reserve(nodes.size());
+	for(size_t i = 0; i < nodes.size(); i++)
+		ids.insert(make_pair(nodes[i], (uint32_t)i));
+
+	vector<pair<uint32_t, uint32_t>> edges;
+	for(size_t i = 0; i < nodes.size(); i++){
+		const vector<graphNode<G>*>& adj = nodes[i]->connectedTo;
+		for(size_t j = 0; j < adj.size(); j++){
+			pair<typename unordered_map<graphNode<G>*, uint32_t>::iterator, bool> res = ids.insert(make_pair(adj[j], (uint32_t)nodes.size()));
+			if(res.second)
+				nodes.push_back(adj[j]);
+			edges.push_back(make_pair((uint32_t)i, res.first->second));
+		}
+	}
+	return edges;
+}
+
+//builds a csrGraph from graphNode adjacency numbered by assignIds, vertex i is nodes[i]
+//O(n + m log d) expected time
+template<class G>
+csrGraph buildCSR(vector<graphNode<G>*>& nodes){
+	vector<pair<uint32_t, uint32_t>> edges = assignIds(nodes);
+	return csrGraph::fromEdges((uint32_t)nodes.size(), edges);
+}
+
+//disjoint sets over vertices 0 ... n-1 that any number of threads can union and query at once
+//each entry packs (rank << 32 | parent) into one word, so linking a root and bumping a rank are single CAS operations
+//find uses path halving, union links the lower ranked root (ties broken by id) under the other
+//O(α(n)) amortized time per operation
+class concurrentUnionFind
+{
+public:
+	concurrentUnionFind(uint32_t n = 0);
+	concurrentUnionFind(concurrentUnionFind&&) = default;
+	concurrentUnionFind(const concurrentUnionFind&) = delete;
+	concurrentUnionFind& operator=(const concurrentUnionFind&) = delete;
+
+	uint32_t size() const { return (uint32_t)entries.size(); }
+
+	//root of v's set, roots can change while other threads union
+	uint32_t find(uint32_t v);
+
+	//merges the sets of a and b, returns whether they were separate
+	bool unite(uint32_t a, uint32_t b);
+
+	//determines whether a and b are in the same set, linearizable with concurrent unites
+	bool connected(uint32_t a, uint32_t b);
+
+	//unites the endpoints of every edge, spread over threads
+	//O(m α(n) / threads) time
+	void addEdges(const vector<pair<uint32_t, uint32_t>>& edges, unsigned threads = 0);
+
+	//snapshot of component labels, labels[v] == labels[w] exactly when v and w are connected
+	//labels are numbered 0 ... count-1 in order of each component's smallest vertex
+	//take it while no unions are running
+	//O(n α(n)) time
+	vector<uint32_t> componentLabels();
+
+	//number of disjoint sets
+	//O(n) time
+	uint32_t componentCount() const;
+
+private:
+	static uint32_t parentOf(uint64_t e) { return (uint32_t)e; }
+	static uint32_t rankOf(uint64_t e) { return (uint32_t)(e >> 32); }
+
+	vector<atomic<uint64_t>> entries;
+};
+
+//builds a union-find over graphNode adjacency numbered by assignIds, treating every edge as undirected
+//O(n + m α(n)) expected time
 template<class G>
-bool isConnected(graphNode* n1, graphNode* n2);
+concurrentUnionFind buildUnionFind(vector<graphNode<G>*>& nodes){
+	vector<pair<uint32_t, uint32_t>> edges = assignIds(nodes);
+	concurrentUnionFind sets((uint32_t)nodes.size());
+	sets.addEdges(edges, 1);
+	return sets;
+}
+
+//distance reported for unreachable vertices by the shortest path functions
+const uint64_t infiniteDistance = UINT64_MAX;
+
+//indexed 4-ary min-heap over vertex ids 0 ... n-1 with decrease-key
+//positions are tracked per vertex, so clear() only touches what is still in the heap and the heap can be reused
+//O(log n) push and pop
+template<class Key>
+class indexedDaryHeap
+{
+public:
+	indexedDaryHeap(uint32_t n = 0) : pos(n, absent) {}
+
+	bool empty() const { return heap.empty(); }
+	size_t size() const { return heap.size(); }
+	bool contains(uint32_t v) const { return pos[v] != absent; }
+
+	//vertex with the smallest key and that key
+	uint32_t top() const { return heap[0].second; }
+	const Key& topKey() const { return heap[0].first; }
+
+	//inserts v with key, or lowers v's key if it is already present with a larger one
+	void push(uint32_t v, const Key& key){
+		uint32_t i = pos[v];
+		if(i == absent){
+			i = (uint32_t)heap.size();
+			heap.push_back(make_pair(key, v));
+			pos[v] = i;
+		}
+		else if(key < heap[i].first)
+			heap[i].first = key;
+		else
+			return;
+		siftUp(i);
+	}
+
+	//removes and returns the vertex with the smallest key
+	uint32_t pop(){
+		uint32_t v = heap[0].second;
+		pos[v] = absent;
+		if(heap.size() > 1){
+			heap[0] = heap.back();
+			pos[heap[0].second] = 0;
+			heap.pop_back();
+			siftDown(0);
+		}
+		else
+			heap.pop_back();
+		return v;
+	}
+
+	void clear(){
+		for(size_t i = 0; i < heap.size(); i++)
+			pos[heap[i].second] = absent;
+		heap.clear();
+	}
+
+private:
+	static const uint32_t absent = UINT32_MAX;
+
+	void siftUp(uint32_t i){
+		pair<Key, uint32_t> item = heap[i];
+		while(i > 0){
+			uint32_t parent = (i - 1) / 4;
+			if(!(item.first < heap[parent].first))
+				break;
+			heap[i] = heap[parent];
+			pos[heap[i].second] = i;
+			i = parent;
+		}
+		heap[i] = item;
+		pos[item.second] = i;
+	}
+
+	void siftDown(uint32_t i){
+		pair<Key, uint32_t> item = heap[i];
+		uint32_t n = (uint32_t)heap.size();
+		while(true){
+			uint32_t first = 4 * i + 1;
+			if(first >= n)
+				break;
+			uint32_t best = first;
+			uint32_t last = min(first + 4, n);
+			for(uint32_t c = first + 1; c < last; c++){
+				if(heap[c].first < heap[best].first)
+					best = c;
+			}
+			if(!(heap[best].first < item.first))
+				break;
+			heap[i] = heap[best];
+			pos[heap[i].second] = i;
+			i = best;
+		}
+		heap[i] = item;
+		pos[item.second] = i;
+	}
+
+	vector<pair<Key, uint32_t>> heap;
+	vector<uint32_t> pos;
+};
+
+//absent is bound to const references (pos(n, absent)), so it needs a definition outside the class
+template<class Key>
+const uint32_t indexedDaryHeap<Key>::absent;
+
+//single source shortest paths with Dijkstra's algorithm on a radix heap, edge weights from csrGraph::edgeWeight
+//the radix heap exploits monotone integer keys: each entry moves down at most 64 buckets over its lifetime
+//returns infiniteDistance for unreachable vertices
+//O(m + n log C) time, C = largest edge weight
+vector<uint64_t> dijkstra(const csrGraph& g, uint32_t source);
+
+//single source shortest paths with parallel delta-stepping
+//vertices are bucketed by distance / delta, light edges (weight <= delta) of a bucket are relaxed repeatedly in
+//parallel until it empties, then its heavy edges once; delta = 0 picks the mean edge weight
+//returns the same distances as dijkstra
+vector<uint64_t> deltaStepping(const csrGraph& g, uint32_t source, uint64_t delta = 0, unsigned threads = 0);
+
+//point to point shortest path queries over a weighted csrGraph and its transpose (pass the same graph twice if undirected)
+//per-query state is stamped like bfsEngine, so queries cost only what they explore; use one engine per thread
+class shortestPathEngine
+{
+public:
+	shortestPathEngine(const csrGraph& out, const csrGraph& in);
+	shortestPathEngine(const shortestPathEngine&) = delete;
+	shortestPathEngine& operator=(const shortestPathEngine&) = delete;
+
+	//shortest distance from source to target with bidirectional Dijkstra, infiniteDistance if unreachable
+	//the side with the smaller heap advances, stopping once the two heap minimums add up to the best meeting
+	uint64_t distance(uint32_t source, uint32_t target);
+
+	//shortest distance from source to target with A*, infiniteDistance if unreachable
+	//heuristic(v) must never overestimate the distance from v to target; vertices are reopened when an
+	//inconsistent heuristic finds a shorter path to them later
+	template<class Heuristic>
+	uint64_t aStar(uint32_t source, uint32_t target, Heuristic heuristic){
+		if(source >= out.vertexCount() || target >= out.vertexCount())
+			return infiniteDistance;
+		newQuery();
+		setDistance(forwardSeen, forwardDist, source, 0);
+		forwardHeap.push(source, heuristic(source));
+
+		uint64_t result = infiniteDistance;
+		while(!forwardHeap.empty()){
+			uint32_t u = forwardHeap.pop();
+			if(u == target){
+				result = forwardDist[u];
+				break;
+			}
+			uint64_t du = forwardDist[u];
+			for(uint64_t e = out.edgesBegin(u); e < out.edgesEnd(u); e++){
+				uint32_t w = out.edgeTarget(e);
+				uint64_t nd = du + out.edgeWeight(e);
+				if(nd < distanceOf(forwardSeen, forwardDist, w)){
+					setDistance(forwardSeen, forwardDist, w, nd);
+					forwardHeap.push(w, nd + heuristic(w));
+				}
+			}
+		}
+		forwardHeap.clear();
+		return result;
+	}
+
+private:
+	void newQuery();
+
+	uint64_t distanceOf(const vector<uint32_t>& seen, const vector<uint64_t>& dist, uint32_t v) const{
+		return seen[v] == query ? dist[v] : infiniteDistance;
+	}
+
+	void setDistance(vector<uint32_t>& seen, vector<uint64_t>& dist, uint32_t v, uint64_t d){
+		seen[v] = query;
+		dist[v] = d;
+	}
+
+	const csrGraph& out;
+	const csrGraph& in;
+	vector<uint64_t> forwardDist, backwardDist;
+	vector<uint32_t> forwardSeen, backwardSeen;
+	uint32_t query = 0;
+	indexedDaryHeap<uint64_t> forwardHeap, backwardHeap;
+};
+
+//connected components with Afforest: every vertex is first linked to a couple of its neighbors, the largest
+//component is estimated from a sample, and only vertices outside it link their remaining edges
+//undirected graphs must store both directions; pass undirected = false for weak components of a directed graph,
+//which disables the skipping
+//labels[v] == labels[w] exactly when connected, numbered 0 ... count-1 by smallest vertex
+//O(m α(n) / threads) time
+vector<uint32_t> connectedComponents(const csrGraph& g, bool undirected = true, unsigned threads = 0);
+
+//strongly connected components with an iterative Tarjan walk, no recursion so deep graphs are safe
+//component ids come out in reverse topological order of the condensation: no edge leads from a component to a higher id
+//count receives the number of components
+//O(n + m) time
+vector<uint32_t> stronglyConnectedComponents(const csrGraph& g, uint32_t& count);
+
+//topological order with Kahn's algorithm, each frontier of zero in-degree vertices is processed in parallel
+//order lists every vertex once frontier by frontier, returns false (with a partial order) if the graph has a cycle
+//O(n + m) time
+bool topologicalSort(const csrGraph& g, vector<uint32_t>& order, unsigned threads = 0);
+
+//vertex orderings for locality: each returns newId with newId[v] the position of v, ready for csrGraph::relabel
+
+//reverse Cuthill-McKee: breadth first from a low degree vertex of each component, neighbors taken in increasing
+//degree, then the whole order reversed, which keeps neighbors close and the adjacency matrix banded
+//O(n + m log d) time
+vector<uint32_t> reverseCuthillMcKee(const csrGraph& g);
+
+//hubs first: vertices sorted by decreasing degree, ties kept in id order
+//O(n) time
+vector<uint32_t> degreeOrder(const csrGraph& g);
+
+//Gorder-style greedy order: repeatedly places the vertex sharing the most edges and common neighbors with the
+//last window placed vertices; neighbors of hubs (degree > sqrt(n)) are not scored, as in Gorder
+//O(Σ d² log n) time for non-hub vertices
+vector<uint32_t> gorderLite(const csrGraph& g, uint32_t window = 5);
+
+//splits an undirected graph (both directions stored) into k parts of nearly equal size with few cut edges
+//multilevel: heavy edge matching coarsens the graph, the coarsest graph is cut into k chunks of a breadth first
+//order, then each level is projected back and refined by greedy boundary moves that keep every part within
+//imbalance * n / k vertices; part[v] is in 0 ... k-1
+//O((n + m) log n) time
+vector<uint32_t> partitionGraph(const csrGraph& g, uint32_t k, double imbalance = 1.03);
+
+//number of undirected edges whose endpoints are in different parts (each stored direction counts half)
+//O(m) time
+uint64_t partitionCut(const csrGraph& g, const vector<uint32_t>& part);
 
 /*
 * Trees
 */
 
-//Level order traversal using queue
-//O(n) time complexity, n = number of nodes in tree
-//visits node at each level and add children to queue similar to BFS
-template<class V>
-void levelOrder(treeNode* root);
-
-//Level order traversal using queue in spiral using two stacks
-//O(n) time complexity, O(n) space, n = number of nodes in tree
-//visits node at each level and add children to two stacks to traverse in a spiral
-template<class V>
-void levelOrderSpiral(treeNode* root);
-
 //determines whether a binary tree is balanced
 //O(n) time
 template<class V>
-bool isBalanced(treeNode* root, int& height);
+bool isBalanced(treeNode<V>* root, int& height){
+	int leftHeight = 0;
+	int rightHeight = 0;
+
+	bool leftBal = false;
+	bool rightBal = false;
+
+	if(root == nullptr){
+		height = 0;
+		return true;
+	}
+
+	//recur for subtrees
+	leftBal = isBalanced(root->left, leftHeight);
+	rightBal = isBalanced(root->right, rightHeight);
+
+	height = max(leftHeight, rightHeight) + 1;
+
+	//not balanced
+	if((leftHeight - rightHeight > 1) || (rightHeight - leftHeight > 1))
+		return false;
+	//balanced if subtrees and current tree are balanced
+	else
+		return (leftBal && rightBal);
+}
 
 //determines whether a binary tree is a binary search tree using min/max algorithm
 //O(n) time
 template<class V>
-bool isBST(treeNode* root, int min, int max);
+bool isBST(treeNode<V>* root, int min, int max){
+	if(root == nullptr)
+		return true;
+
+	//check if data is within valid range
+	if(root->data <= min || root->data > max)
+		return false;
+
+	return (isBST(root->left, min, root->data) && isBST(root->right, root->data, max));
+}
 
 //returns the leftmost child in the tree starting at root
 //O(h) time, h = height of tree
 template<class V>
-treeNode* leftMostChild(treeNode* root);
+treeNode<V>* leftMostChild(treeNode<V>* root){
+	if(root == nullptr)
+		return nullptr;
+	treeNode<V>* curr = root;
+	while(curr->left != nullptr)
+		curr = curr->left;
+	return curr;
+}
 
 //finds the in-order successor to the given node in a BST (assuming node has parent pointer)
 template<class V>
-treeNode* inorderSucc(treeNode* root);
+treeNode<V>* inorderSucc(treeNode<V>* root){
+	//if has right child, find leftmost child of right child
+	if(root->right != nullptr)
+		return leftMostChild(root->right);
+	//go up the tree until a node whose left child is this node
+	else{
+		treeNode<V>* s = root;
+		treeNode<V>* t = s->parent;
+		while(t != nullptr && s != t->left){
+			s = t;
+			t = t->parent;
+		}
+		return t;
+	}
+}
 
 //finds the in-order successor to the given node in a BST (assuming node has no parent pointer)
 template<class V>
-treeNode* inorderSucc(treeNode* root, treeNode* node);
+treeNode<V>* inorderSucc(treeNode<V>* root, treeNode<V>* node){
+	//if has right child, find leftmost child of right child
+	if(node->right != nullptr)
+		return leftMostChild(node->right);
+
+	//traverse down from root to find succ
+	treeNode<V>* succ = nullptr;
+	while(root != nullptr){
+		if(node->data < root->data){
+			succ = root;
+			root = root->left;
+		}
+		else if(node->data > root->data)
+			root = root->right;
+		else
+			break;
+	}
+	return succ;
+}
 
 //finds the lowest common ancestor of n1 and n2 in a binary tree
 //O(n) time
 template<class V>
-treeNode* BT_LCA(treeNode* root, treeNode* n1, treeNode* n2);
+treeNode<V>* BT_LCA(treeNode<V>* root, treeNode<V>* n1, treeNode<V>* n2){
+	if(root == nullptr)
+		return nullptr;
+
+	//found node in tree
+	if(root->data == n1->data || root->data == n2->data)
+		return root;
+
+	//recur left and right
+	treeNode<V>* left = BT_LCA(root->left, n1, n2);
+	treeNode<V>* right = BT_LCA(root->right, n1, n2);
+
+	//if found in both left and right subtrees, this node must be the LCA
+	if(left && right)
+		return root;
+
+	//if only found in 1 subtree, returned node must be LCA
+	if(left != nullptr)
+		return left;
+	else
+		return right;
+}
 
 //finds the lowest common ancestor of n1 and n2 in a binary search tree
 //O(h) time
 template<class V>
-treeNode* BST_LCA(treeNode* root, treeNode* n1, treeNode* n2);
+treeNode<V>* BST_LCA(treeNode<V>* root, treeNode<V>* n1, treeNode<V>* n2){
+	//use property of BST to find LCA
+	while(root != nullptr){
+		if(n1->data < root->data && n2->data < root->data)
+			root = root->left;
+		else if(n1->data > root->data && n2->data > root->data)
+			root = root->right;
+		else
+			break;
+	}
+	return root;
+}
 
 //determines whether two trees match each other
 template<class V>
 bool treeMatch(treeNode* t1, treeNode* t2);
 
-//determines whether t1 contains t2 as a subtree
-template<class V>
-bool containsTree(treeNode* t1, treeNode* t2);
-
 //finds the maximum path sum in a binary tree
 template<class V>
 int maxPathSum(treeNode* root, int& maxSum);
 
-//prints the nodes of a binary tree seen from the left view
-template<class V>
-void printLeftView(treeNode* root);
-
 //prints the common nodes in two binary search trees
 //O(h1 + h2) space, O(n) time
 template<class V>
 void commonNodesBSTs(treeNode* r1, treeNode* r2);
 
+//node of avlTree, a treeNode with the extra balance bookkeeping appended
+//the tree algorithms above take it as a plain treeNode<V>*
+template<class V>
+struct avlNode : treeNode<V>
+{
+	int height;
+	size_t count;
+};
+
+//ordered set kept height balanced with AVL rotations, built from treeNode shaped nodes (parent pointers kept)
+//supports order statistics through per-node subtree sizes
+template<class V>
+class avlTree
+{
+public:
+	avlTree() {}
+	~avlTree() { clear(); }
+	avlTree(const avlTree&) = delete;
+	avlTree& operator=(const avlTree&) = delete;
+
+	//root of the tree, usable with isBST, isBalanced, inorderSucc, BST_LCA, ...
+	treeNode<V>* root() const { return rootNode; }
+
+	size_t size() const { return count(rootNode); }
+
+	//inserts key, returns false if it was already present
+	//O(log n) time
+	bool insert(const V& key){
+		bool inserted = false;
+		rootNode = insertAt(rootNode, key, inserted);
+		rootNode->parent = nullptr;
+		return inserted;
+	}
+
+	//removes key, returns false if it was not present
+	//O(log n) time
+	bool erase(const V& key){
+		bool erased = false;
+		rootNode = eraseAt(rootNode, key, erased);
+		if(rootNode)
+			rootNode->parent = nullptr;
+		return erased;
+	}
+
+	//node holding key, nullptr if missing
+	//O(log n) time
+	treeNode<V>* find(const V& key) const {
+		treeNode<V>* t = rootNode;
+		while(t != nullptr){
+			if(key < t->data)
+				t = t->left;
+			else if(t->data < key)
+				t = t->right;
+			else
+				return t;
+		}
+		return nullptr;
+	}
+
+	//node holding the kth smallest key (0 based), nullptr if k >= size()
+	//O(log n) time
+	treeNode<V>* select(size_t k) const {
+		treeNode<V>* t = rootNode;
+		while(t != nullptr){
+			size_t leftCount = count(t->left);
+			if(k < leftCount)
+				t = t->left;
+			else if(k == leftCount)
+				return t;
+			else{
+				k -= leftCount + 1;
+				t = t->right;
+			}
+		}
+		return nullptr;
+	}
+
+	//number of keys smaller than key
+	//O(log n) time
+	size_t rank(const V& key) const {
+		size_t r = 0;
+		treeNode<V>* t = rootNode;
+		while(t != nullptr){
+			if(t->data < key){
+				r += count(t->left) + 1;
+				t = t->right;
+			}
+			else
+				t = t->left;
+		}
+		return r;
+	}
+
+	//replaces the contents with strictly increasing keys, building a perfectly balanced tree
+	//O(n) time
+	void bulkLoad(const vector<V>& sorted){
+		clear();
+		rootNode = buildFrom(sorted, 0, sorted.size(), nullptr);
+	}
+
+	//frees every node
+	//O(n) time
+	void clear(){
+		vector<treeNode<V>*> stack;
+		if(rootNode)
+			stack.push_back(rootNode);
+		while(!stack.empty()){
+			treeNode<V>* t = stack.back();
+			stack.pop_back();
+			if(t->left)
+				stack.push_back(t->left);
+			if(t->right)
+				stack.push_back(t->right);
+			delete node(t);
+		}
+		rootNode = nullptr;
+	}
+
+private:
+	static avlNode<V>* node(treeNode<V>* t){ return static_cast<avlNode<V>*>(t); }
+	static int height(treeNode<V>* t){ return t ? node(t)->height : 0; }
+	static size_t count(treeNode<V>* t){ return t ? node(t)->count : 0; }
+
+	static avlNode<V>* newNode(const V& key, treeNode<V>* parent){
+		avlNode<V>* n = new avlNode<V>();
+		n->data = key;
+		n->left = n->right = nullptr;
+		n->parent = parent;
+		n->height = 1;
+		n->count = 1;
+		return n;
+	}
+
+	// recomputes t's bookkeeping and points its children back at it
+	static void update(treeNode<V>* t){
+		node(t)->height = max(height(t->left), height(t->right)) + 1;
+		node(t)->count = count(t->left) + count(t->right) + 1;
+		if(t->left)
+			t->left->parent = t;
+		if(t->right)
+			t->right->parent = t;
+	}
+
+	static treeNode<V>* rotateRight(treeNode<V>* t){
+		treeNode<V>* l = t->left;
+		t->left = l->right;
+		l->right = t;
+		update(t);
+		update(l);
+		return l;
+	}
+
+	static treeNode<V>* rotateLeft(treeNode<V>* t){
+		treeNode<V>* r = t->right;
+		t->right = r->left;
+		r->left = t;
+		update(t);
+		update(r);
+		return r;
+	}
+
+	// restores the AVL property at t (children already balanced), returns the new subtree root
+	static treeNode<V>* rebalance(treeNode<V>* t){
+		update(t);
+		int balance = height(t->left) - height(t->right);
+		if(balance > 1){
+			if(height(t->left->left) < height(t->left->right))
+				t->left = rotateLeft(t->left);
+			return rotateRight(t);
+		}
+		if(balance < -1){
+			if(height(t->right->right) < height(t->right->left))
+				t->right = rotateRight(t->right);
+			return rotateLeft(t);
+		}
+		return t;
+	}
+
+	treeNode<V>* insertAt(treeNode<V>* t, const V& key, bool& inserted){
+		if(t == nullptr){
+			inserted = true;
+			return newNode(key, nullptr);
+		}
+		if(key < t->data)
+			t->left = insertAt(t->left, key, inserted);
+		else if(t->data < key)
+			t->right = insertAt(t->right, key, inserted);
+		else
+			return t;
+		return inserted ? rebalance(t) : t;
+	}
+
+	// detaches the smallest node of t into min, returns the remaining subtree
+	treeNode<V>* removeMin(treeNode<V>* t, treeNode<V>*& min){
+		if(t->left == nullptr){
+			min = t;
+			return t->right;
+		}
+		t->left = removeMin(t->left, min);
+		return rebalance(t);
+	}
+
+	treeNode<V>* eraseAt(treeNode<V>* t, const V& key, bool& erased){
+		if(t == nullptr)
+			return nullptr;
+		if(key < t->data)
+			t->left = eraseAt(t->left, key, erased);
+		else if(t->data < key)
+			t->right = eraseAt(t->right, key, erased);
+		else{
+			erased = true;
+			treeNode<V>* l = t->left;
+			treeNode<V>* r = t->right;
+			delete node(t);
+			if(r == nullptr)
+				return l;
+
+			//successor node takes the erased node's place
+			treeNode<V>* succ = nullptr;
+			r = removeMin(r, succ);
+			succ->left = l;
+			succ->right = r;
+			return rebalance(succ);
+		}
+		return erased ? rebalance(t) : t;
+	}
+
+	treeNode<V>* buildFrom(const vector<V>& sorted, size_t lo, size_t hi, treeNode<V>* parent){
+		if(lo >= hi)
+			return nullptr;
+		size_t mid = lo + (hi - lo) / 2;
+		avlNode<V>* t = newNode(sorted[mid], parent);
+		t->left = buildFrom(sorted, lo, mid, t);
+		t->right = buildFrom(sorted, mid + 1, hi, t);
+		update(t);
+		return t;
+	}
+
+	treeNode<V>* rootNode = nullptr;
+};
+
+//read-only copy of a BST laid out in one array in Eytzinger (BFS) order
+//children of index i are 2i and 2i+1 (index 0 is unused, 0 also means "not found"),
+//so a search touches one cache line per few levels and needs no pointers
+template<class V>
+class frozenBST
+{
+public:
+	//copies the keys of the BST rooted at root, the source tree is left untouched
+	//O(n) time
+	frozenBST(treeNode<V>* root){
+		//iterative in-order traversal gives the keys in sorted order
+		vector<V> sorted;
+		vector<treeNode<V>*> stack;
+		treeNode<V>* curr = root;
+		while(curr != nullptr || !stack.empty()){
+			while(curr != nullptr){
+				stack.push_back(curr);
+				curr = curr->left;
+			}
+			curr = stack.back();
+			stack.pop_back();
+			sorted.push_back(curr->data);
+			curr = curr->right;
+		}
+		build(sorted);
+	}
+
+	//builds from keys that are already sorted
+	//O(n) time
+	frozenBST(const vector<V>& sorted){
+		build(sorted);
+	}
+
+	size_t size() const { return n; }
+
+	//key stored at index i (1 <= i <= size())
+	const V& key(size_t i) const { return keys[i]; }
+
+	//index of key, 0 if missing
+	//O(log n) time
+	size_t find(const V& k) const {
+		size_t i = lowerBound(k);
+		return (i != 0 && !(k < keys[i])) ? i : 0;
+	}
+
+	//index of the smallest key >= k, 0 if none
+	//O(log n) time, branch free descent
+	size_t lowerBound(const V& k) const {
+		size_t i = 1;
+		while(i <= n){
+#if defined(__GNUC__)
+			//children 4 levels down share one or two cache lines for small keys
+			if(16 * i <= n)
+				__builtin_prefetch(&keys[16 * i]);
+#endif
+			i = 2 * i + (keys[i] < k);
+		}
+		//undo the right turns taken after the last left turn
+		return i >> (countTrailingOnes(i) + 1);
+	}
+
+	//index of the smallest key > k (in-order successor of k), 0 if none
+	//O(log n) time
+	size_t upperBound(const V& k) const {
+		size_t i = 1;
+		while(i <= n)
+			i = 2 * i + !(k < keys[i]);
+		return i >> (countTrailingOnes(i) + 1);
+	}
+
+	//in-order successor of index i, 0 if i holds the largest key
+	//O(1) amortized time
+	size_t next(size_t i) const {
+		//leftmost node of the right subtree
+		if(2 * i + 1 <= n){
+			i = 2 * i + 1;
+			while(2 * i <= n)
+				i = 2 * i;
+			return i;
+		}
+		//otherwise climb while i is a right child, then one more step
+		return i >> (countTrailingOnes(i) + 1);
+	}
+
+	//index of the lowest common ancestor of keys a and b in the frozen tree, 0 if the tree is empty
+	//O(log n) time
+	size_t lca(const V& a, const V& b) const {
+		const V& lo = (b < a) ? b : a;
+		const V& hi = (b < a) ? a : b;
+		size_t i = 1;
+		while(i <= n){
+			if(hi < keys[i])
+				i = 2 * i;
+			else if(keys[i] < lo)
+				i = 2 * i + 1;
+			else
+				return i;
+		}
+		return 0;
+	}
+
+	//calls visit on every key in [lo, hi) in sorted order
+	//O(log n + k) time, k = number of keys visited
+	template<class F>
+	void forEachInRange(const V& lo, const V& hi, F visit) const {
+		for(size_t i = lowerBound(lo); i != 0 && keys[i] < hi; i = next(i))
+			visit(keys[i]);
+	}
+
+private:
+	static int countTrailingOnes(size_t i){
+#if defined(__GNUC__)
+		return __builtin_ctzll(~(unsigned long long)i);
+#else
+		int count = 0;
+		while(i & 1){
+			count++;
+			i >>= 1;
+		}
+		return count;
+#endif
+	}
+
+	void build(const vector<V>& sorted){
+		n = sorted.size();
+		keys.assign(n + 1, V());
+		size_t pos = 0;
+		place(sorted, pos, 1);
+	}
+
+	// in-order walk over implicit indices places the sorted keys in BFS order
+	void place(const vector<V>& sorted, size_t& pos, size_t i){
+		if(i > n)
+			return;
+		place(sorted, pos, 2 * i);
+		keys[i] = sorted[pos++];
+		place(sorted, pos, 2 * i + 1);
+	}
+
+	vector<V> keys;
+	size_t n = 0;
+};
+
+//folds a binary tree bottom up: result(node) = combine(node, result(left), result(right)), result(nullptr) = empty
+//post-order with an explicit stack, so depth is limited by memory rather than the call stack
+//O(n) time, O(h) space
+template<class V, class R, class Combine>
+R foldTree(treeNode<V>* root, const R& empty, Combine combine){
+	vector<pair<treeNode<V>*, bool>> stack;
+	vector<R> results;
+	stack.push_back(make_pair(root, false));
+
+	while(!stack.empty()){
+		pair<treeNode<V>*, bool> top = stack.back();
+		stack.pop_back();
+		if(top.first == nullptr)
+			results.push_back(empty);
+		else if(!top.second){
+			//revisit after both children, left child ends up below right on the results stack
+			stack.push_back(make_pair(top.first, true));
+			stack.push_back(make_pair(top.first->right, false));
+			stack.push_back(make_pair(top.first->left, false));
+		}
+		else{
+			R right = results.back();
+			results.pop_back();
+			R left = results.back();
+			results.pop_back();
+			results.push_back(combine(top.first, left, right));
+		}
+	}
+	return results.back();
+}
+
+//splits a tree for fork-join processing: nodes near the root are expanded breadth first into top
+//(parents before children) and the unexpanded subtrees left in the queue become independent tasks
+//expansion stops at tasks target subtrees or once budget nodes have been expanded
+template<class V>
+void splitTree(treeNode<V>* root, size_t target, size_t budget, vector<treeNode<V>*>& top, vector<treeNode<V>*>& tasks){
+	top.clear();
+	tasks.clear();
+	if(root == nullptr)
+		return;
+
+	vector<treeNode<V>*> queue(1, root);
+	size_t head = 0;
+	while(head < queue.size() && queue.size() - head < target && top.size() < budget){
+		treeNode<V>* n = queue[head++];
+		top.push_back(n);
+		if(n->left)
+			queue.push_back(n->left);
+		if(n->right)
+			queue.push_back(n->right);
+	}
+	tasks.assign(queue.begin() + head, queue.end());
+}
+
+//runs work(i) for every i in [0, count) on up to threads threads
+//idle threads take the next unclaimed task, so uneven subtrees balance out dynamically
+//threads - 1 std::threads are spawned and joined on every call (the caller is the last worker), there is no
+//persistent pool, so each call pays thread start up and should carry enough work to amortize it
+template<class Work>
+void runTasks(size_t count, unsigned threads, Work work){
+	if(threads == 0)
+		threads = max(1u, thread::hardware_concurrency());
+	threads = (unsigned)min((size_t)threads, count);
+
+	atomic<size_t> next(0);
+	auto worker = [&](){
+		for(size_t i = next++; i < count; i = next++)
+			work(i);
+	};
+
+	vector<thread> helpers;
+	for(unsigned t = 1; t < threads; t++)
+		helpers.push_back(thread(worker));
+	if(threads > 0)
+		worker();
+	for(size_t t = 0; t < helpers.size(); t++)
+		helpers[t].join();
+}
+
+//foldTree that processes independent subtrees in parallel
+//the top of the tree is split into about 8 tasks per thread, each folded iteratively, then combined sequentially
+//O(n / threads + top) time
+template<class V, class R, class Combine>
+R parallelFoldTree(treeNode<V>* root, const R& empty, Combine combine, unsigned threads = 0){
+	if(threads == 0)
+		threads = max(1u, thread::hardware_concurrency());
+	if(threads == 1)
+		return foldTree(root, empty, combine);
+
+	vector<treeNode<V>*> top, tasks;
+	splitTree(root, 8 * (size_t)threads, (size_t)1 << 16, top, tasks);
+
+	vector<R> taskResults(tasks.size(), empty);
+	runTasks(tasks.size(), threads, [&](size_t i){
+		taskResults[i] = foldTree(tasks[i], empty, combine);
+	});
+
+	//children of the top nodes are either top nodes or tasks, so combine top nodes deepest first
+	unordered_map<treeNode<V>*, R> results;
+	results.reserve(top.size() + tasks.size());
+	for(size_t i = 0; i < tasks.size(); i++)
+		results[tasks[i]] = taskResults[i];
+	for(size_t i = top.size(); i-- > 0; ){
+		treeNode<V>* n = top[i];
+		R left = n->left ? results[n->left] : empty;
+		R right = n->right ? results[n->right] : empty;
+		results[n] = combine(n, left, right);
+	}
+	return root ? results[root] : empty;
+}
+
+//parallel version of maxPathSum, returns the maximum path sum (0 for an empty tree)
+//O(n / threads) time, no recursion
+template<class V>
+V parallelMaxPathSum(treeNode<V>* root, unsigned threads = 0){
+	//first = best path going down from the node, second = best path anywhere in the subtree
+	typedef pair<V, V> sums;
+	if(root == nullptr)
+		return V();
+	sums res = parallelFoldTree(root, make_pair(V(), root->data), [](treeNode<V>* n, const sums& l, const sums& r){
+		V single = max(max(l.first, r.first) + n->data, n->data);
+		V through = max(single, l.first + r.first + n->data);
+		return make_pair(single, max(through, max(l.second, r.second)));
+	}, threads);
+	return res.second;
+}
+
+//parallel version of isBalanced, sets height as well
+//O(n / threads) time, no recursion
+template<class V>
+bool parallelIsBalanced(treeNode<V>* root, int& height, unsigned threads = 0){
+	typedef pair<bool, int> balance;
+	balance res = parallelFoldTree(root, make_pair(true, 0), [](treeNode<V>*, const balance& l, const balance& r){
+		bool ok = l.first && r.first && abs(l.second - r.second) <= 1;
+		return make_pair(ok, max(l.second, r.second) + 1);
+	}, threads);
+	height = res.second;
+	return res.first;
+}
+
+//parallel version of isBST, left subtree values <= node < right subtree values
+//O(n / threads) time, no recursion
+template<class V>
+bool parallelIsBST(treeNode<V>* root, unsigned threads = 0){
+	//valid, empty, min, max of the subtree
+	struct range
+	{
+		bool ok;
+		bool empty;
+		V lo;
+		V hi;
+	};
+	range none = { true, true, V(), V() };
+	range res = parallelFoldTree(root, none, [](treeNode<V>* n, const range& l, const range& r){
+		range out = { false, false, n->data, n->data };
+		if(!l.ok || !r.ok)
+			return out;
+		if(!l.empty && n->data < l.hi)
+			return out;
+		if(!r.empty && !(n->data < r.lo))
+			return out;
+		out.ok = true;
+		if(!l.empty)
+			out.lo = l.lo;
+		if(!r.empty)
+			out.hi = r.hi;
+		return out;
+	}, threads);
+	return res.ok;
+}
+
+//parallel version of BT_LCA, nodes are matched by data like BT_LCA
+//O(n / threads) time, no recursion
+template<class V>
+treeNode<V>* parallelBT_LCA(treeNode<V>* root, treeNode<V>* n1, treeNode<V>* n2, unsigned threads = 0){
+	return parallelFoldTree(root, (treeNode<V>*)nullptr, [n1, n2](treeNode<V>* n, treeNode<V>* l, treeNode<V>* r){
+		if(n->data == n1->data || n->data == n2->data)
+			return n;
+		if(l && r)
+			return n;
+		return l ? l : r;
+	}, threads);
+}
+
+//determines whether two trees match each other, walking both with an explicit stack
+//stops at the first difference if stop becomes true (set by another thread)
+//O(n) time, O(h) space
+template<class V>
+bool treeMatchIterative(treeNode<V>* t1, treeNode<V>* t2, const atomic<bool>* stop = nullptr){
+	vector<pair<treeNode<V>*, treeNode<V>*>> stack(1, make_pair(t1, t2));
+	while(!stack.empty()){
+		if(stop && stop->load(memory_order_relaxed))
+			return false;
+		pair<treeNode<V>*, treeNode<V>*> p = stack.back();
+		stack.pop_back();
+		if(p.first == nullptr && p.second == nullptr)
+			continue;
+		if(p.first == nullptr || p.second == nullptr || p.first->data != p.second->data)
+			return false;
+		stack.push_back(make_pair(p.first->right, p.second->right));
+		stack.push_back(make_pair(p.first->left, p.second->left));
+	}
+	return true;
+}
+
+//parallel version of treeMatch, matching subtree pairs are compared on separate threads
+//O(n / threads) time, no recursion
+template<class V>
+bool parallelTreeMatch(treeNode<V>* t1, treeNode<V>* t2, unsigned threads = 0){
+	//expand both trees together breadth first until there are enough pairs to hand out
+	if(threads == 0)
+		threads = max(1u, thread::hardware_concurrency());
+	vector<pair<treeNode<V>*, treeNode<V>*>> queue(1, make_pair(t1, t2));
+	size_t head = 0;
+	while(head < queue.size() && queue.size() - head < 8 * (size_t)threads && head < ((size_t)1 << 16)){
+		pair<treeNode<V>*, treeNode<V>*> p = queue[head++];
+		if(p.first == nullptr && p.second == nullptr)
+			continue;
+		if(p.first == nullptr || p.second == nullptr || p.first->data != p.second->data)
+			return false;
+		queue.push_back(make_pair(p.first->left, p.second->left));
+		queue.push_back(make_pair(p.first->right, p.second->right));
+	}
+
+	atomic<bool> mismatch(false);
+	runTasks(queue.size() - head, threads, [&](size_t i){
+		if(!treeMatchIterative(queue[head + i].first, queue[head + i].second, &mismatch))
+			mismatch = true;
+	});
+	return !mismatch;
+}
+
+//parallel version of containsTree, subtrees of t1 are searched for t2 on separate threads
+//O(n * m / threads) time worst case, no recursion
+template<class V>
+bool parallelContainsTree(treeNode<V>* t1, treeNode<V>* t2, unsigned threads = 0){
+	if(t2 == nullptr)
+		return true;
+
+	vector<treeNode<V>*> top, tasks;
+	splitTree(t1, 8 * (size_t)max(1u, threads ? threads : thread::hardware_concurrency()), (size_t)1 << 16, top, tasks);
+	for(size_t i = 0; i < top.size(); i++){
+		if(top[i]->data == t2->data && treeMatchIterative(top[i], t2))
+			return true;
+	}
+
+	//each task walks its subtree and tries a match at every node with the right data
+	atomic<bool> found(false);
+	runTasks(tasks.size(), threads, [&](size_t i){
+		vector<treeNode<V>*> stack(1, tasks[i]);
+		while(!stack.empty() && !found.load(memory_order_relaxed)){
+			treeNode<V>* n = stack.back();
+			stack.pop_back();
+			if(n->data == t2->data && treeMatchIterative(n, t2, &found))
+				found = true;
+			if(n->left)
+				stack.push_back(n->left);
+			if(n->right)
+				stack.push_back(n->right);
+		}
+	});
+	return found;
+}
+
+//hash-conses subtrees: structurally equal subtrees (same shape and data) get the same id
+//a node's id is interned from (data, left id, right id), so ids are exact, there are no hash collisions to verify
+//empty subtree has id 0, ids start at 1
+template<class V>
+class subtreeInterner
+{
+public:
+	//interns every subtree of root, returns the id of root
+	//O(n) expected time, no recursion
+	int intern(treeNode<V>* root){
+		return foldTree(root, 0, [this](treeNode<V>* n, int l, int r){
+			return intern(n->data, l, r);
+		});
+	}
+
+	//interns the subtree with root data and children ids l and r, returns its id
+	//O(1) expected time
+	int intern(const V& data, int l, int r){
+		pair<typename unordered_map<shape, int, shapeHash>::iterator, bool> res = ids.insert(make_pair(shape(data, l, r), (int)ids.size() + 1));
+		return res.first->second;
+	}
+
+	//returns the id of the subtree rooted at n without interning anything new, -1 if it has not been interned
+	int lookup(treeNode<V>* n) const{
+		return foldTree(n, 0, [this](treeNode<V>* node, int l, int r){
+			return find(node->data, l, r);
+		});
+	}
+
+	//number of distinct subtrees interned
+	size_t size() const{
+		return ids.size();
+	}
+
+	//id of the subtree with root data and children ids l and r, -1 if not interned
+	int find(const V& data, int l, int r) const{
+		if(l < 0 || r < 0)
+			return -1;
+		typename unordered_map<shape, int, shapeHash>::const_iterator it = ids.find(shape(data, l, r));
+		return it == ids.end() ? -1 : it->second;
+	}
+
+private:
+	struct shape
+	{
+		V data;
+		int left;
+		int right;
+
+		shape(const V& d, int l, int r) : data(d), left(l), right(r) {}
+
+		bool operator==(const shape& o) const{
+			return left == o.left && right == o.right && data == o.data;
+		}
+	};
+
+	struct shapeHash
+	{
+		size_t operator()(const shape& s) const{
+			uint64_t h = hash<V>()(s.data);
+			h = (h ^ ((uint64_t)(unsigned)s.left << 32 | (unsigned)s.right)) * 0x9E3779B97F4A7C15ULL;
+			return (size_t)(h ^ (h >> 29));
+		}
+	};
+
+	unordered_map<shape, int, shapeHash> ids;
+};
+
+//finds a node of t1 whose subtree matches t2, nullptr if t2 is not a subtree of t1 (or is empty)
+//t2 is interned once, then t1 is folded bottom up looking each node up, so subtrees are never compared twice
+//O(n + m) expected time, no recursion
+template<class V>
+treeNode<V>* findSubtree(treeNode<V>* t1, treeNode<V>* t2){
+	if(t2 == nullptr)
+		return nullptr;
+	subtreeInterner<V> interner;
+	int target = interner.intern(t2);
+
+	treeNode<V>* match = nullptr;
+	foldTree(t1, 0, [&](treeNode<V>* n, int l, int r){
+		int id = interner.find(n->data, l, r);
+		if(id == target && match == nullptr)
+			match = n;
+		return id;
+	});
+	return match;
+}
+
+//determines whether t1 contains t2 as a subtree, an empty t2 is contained in any tree
+//interning both trees compares every subtree of t1 to t2 in O(1) rather than re-walking t2 at each node
+//O(n + m) expected time
+template<class V>
+bool containsTree(treeNode<V>* t1, treeNode<V>* t2){
+	return t2 == nullptr || findSubtree(t1, t2) != nullptr;
+}
+
+//groups the nodes of root whose subtrees occur more than once, each group lists every root of one repeated subtree
+//groups are ordered by the first occurrence's post-order position
+//O(n) expected time, no recursion
+template<class V>
+vector<vector<treeNode<V>*>> duplicateSubtrees(treeNode<V>* root){
+	subtreeInterner<V> interner;
+	vector<treeNode<V>*> nodes;
+	vector<int> nodeIds;
+	foldTree(root, 0, [&](treeNode<V>* n, int l, int r){
+		int id = interner.intern(n->data, l, r);
+		nodes.push_back(n);
+		nodeIds.push_back(id);
+		return id;
+	});
+
+	//bucket nodes by id, ids are dense so plain arrays do
+	vector<int> count(interner.size() + 1, 0);
+	for(size_t i = 0; i < nodeIds.size(); i++)
+		count[nodeIds[i]]++;
+	vector<int> group(interner.size() + 1, -1);
+	vector<vector<treeNode<V>*>> groups;
+	for(size_t i = 0; i < nodes.size(); i++){
+		int id = nodeIds[i];
+		if(count[id] < 2)
+			continue;
+		if(group[id] < 0){
+			group[id] = (int)groups.size();
+			groups.push_back(vector<treeNode<V>*>());
+			groups.back().reserve(count[id]);
+		}
+		groups[group[id]].push_back(nodes[i]);
+	}
+	return groups;
+}
+
+//lowest common ancestor index over a fixed tree, matches nodes by address
+//nodes are numbered in preorder; for u before v in preorder, the lca is the parent of the shallowest
+//node in (u, v], so a sparse table of range minimum depths over the preorder answers queries in O(1)
+//O(n log n) preprocessing, the tree must not change while the index is in use
+template<class V>
+class lcaIndex
+{
+public:
+	lcaIndex(treeNode<V>* root){
+		if(root == nullptr)
+			return;
+
+		//preorder numbering with an explicit stack
+		vector<pair<treeNode<V>*, int>> stack(1, make_pair(root, -1));
+		while(!stack.empty()){
+			treeNode<V>* n = stack.back().first;
+			int p = stack.back().second;
+			stack.pop_back();
+			int i = (int)nodes.size();
+			order[n] = i;
+			nodes.push_back(n);
+			parent.push_back(p);
+			depth.push_back(p < 0 ? 0 : depth[p] + 1);
+			if(n->right)
+				stack.push_back(make_pair(n->right, i));
+			if(n->left)
+				stack.push_back(make_pair(n->left, i));
+		}
+
+		//table[k][i] is the shallowest node in [i, i + 2^k)
+		int n = (int)nodes.size();
+		table.push_back(vector<int>(n));
+		for(int i = 0; i < n; i++)
+			table[0][i] = i;
+		for(int k = 1; (1 << k) <= n; k++){
+			const vector<int>& prev = table[k - 1];
+			vector<int> cur(n - (1 << k) + 1);
+			for(size_t i = 0; i < cur.size(); i++)
+				cur[i] = shallower(prev[i], prev[i + (1 << (k - 1))]);
+			table.push_back(cur);
+		}
+	}
+
+	//lowest common ancestor of a and b, nullptr if either is not in the tree
+	//O(1) expected time
+	treeNode<V>* lca(treeNode<V>* a, treeNode<V>* b) const{
+		int i = indexOf(a);
+		int j = indexOf(b);
+		if(i < 0 || j < 0)
+			return nullptr;
+		return nodes[lca(i, j)];
+	}
+
+	//lowest common ancestor by preorder index
+	//O(1) time
+	int lca(int i, int j) const{
+		if(i == j)
+			return i;
+		if(i > j)
+			swap(i, j);
+		int k = 31 - __builtin_clz((unsigned)(j - i));
+		return parent[shallower(table[k][i + 1], table[k][j - (1 << k) + 1])];
+	}
+
+	//answers a batch of queries, results[i] is the lca of queries[i]
+	//O(q) time
+	vector<treeNode<V>*> lca(const vector<pair<treeNode<V>*, treeNode<V>*>>& queries) const{
+		vector<treeNode<V>*> results(queries.size());
+		for(size_t q = 0; q < queries.size(); q++)
+			results[q] = lca(queries[q].first, queries[q].second);
+		return results;
+	}
+
+	//number of edges between a and b, -1 if either is not in the tree
+	//O(1) expected time
+	int distance(treeNode<V>* a, treeNode<V>* b) const{
+		int i = indexOf(a);
+		int j = indexOf(b);
+		if(i < 0 || j < 0)
+			return -1;
+		return depth[i] + depth[j] - 2 * depth[lca(i, j)];
+	}
+
+	//preorder index of n, -1 if n is not in the tree
+	int indexOf(treeNode<V>* n) const{
+		typename unordered_map<treeNode<V>*, int>::const_iterator it = order.find(n);
+		return it == order.end() ? -1 : it->second;
+	}
+
+	//node with preorder index i
+	treeNode<V>* node(int i) const{
+		return nodes[i];
+	}
+
+	size_t size() const{
+		return nodes.size();
+	}
+
+private:
+	int shallower(int i, int j) const{
+		return depth[j] < depth[i] ? j : i;
+	}
+
+	vector<treeNode<V>*> nodes;
+	vector<int> parent;
+	vector<int> depth;
+	vector<vector<int>> table;
+	unordered_map<treeNode<V>*, int> order;
+};
+
+//answers lca queries offline with Tarjan's algorithm, results[i] is the lca of queries[i]
+//one depth first walk merging finished subtrees with union-find, nullptr for nodes not in the tree
+//O((n + q) α(n)) time, no recursion
+template<class V>
+vector<treeNode<V>*> offlineLCA(treeNode<V>* root, const vector<pair<treeNode<V>*, treeNode<V>*>>& queries){
+	vector<treeNode<V>*> results(queries.size(), (treeNode<V>*)nullptr);
+	if(root == nullptr)
+		return results;
+
+	//number nodes in preorder
+	unordered_map<treeNode<V>*, int> order;
+	vector<treeNode<V>*> nodes;
+	vector<treeNode<V>*> walk(1, root);
+	while(!walk.empty()){
+		treeNode<V>* n = walk.back();
+		walk.pop_back();
+		order[n] = (int)nodes.size();
+		nodes.push_back(n);
+		if(n->right)
+			walk.push_back(n->right);
+		if(n->left)
+			walk.push_back(n->left);
+	}
+	int n = (int)nodes.size();
+
+	//queries grouped by endpoint, each query is listed under both of its nodes
+	vector<int> first(n + 1, 0);
+	vector<pair<int, int>> ends(queries.size(), make_pair(-1, -1));
+	for(size_t q = 0; q < queries.size(); q++){
+		typename unordered_map<treeNode<V>*, int>::iterator a = order.find(queries[q].first);
+		typename unordered_map<treeNode<V>*, int>::iterator b = order.find(queries[q].second);
+		if(a == order.end() || b == order.end())
+			continue;
+		ends[q] = make_pair(a->second, b->second);
+		first[a->second + 1]++;
+		first[b->second + 1]++;
+	}
+	for(int i = 0; i < n; i++)
+		first[i + 1] += first[i];
+	vector<int> pending(first[n]);
+	vector<int> fill(first.begin(), first.end() - 1);
+	for(size_t q = 0; q < queries.size(); q++){
+		if(ends[q].first < 0)
+			continue;
+		pending[fill[ends[q].first]++] = (int)q;
+		pending[fill[ends[q].second]++] = (int)q;
+	}
+
+	//union-find over preorder indices with path halving, ancestor[set root] is the set's current ancestor
+	vector<int> link(n), ancestor(n);
+	vector<char> done(n, 0);
+	for(int i = 0; i < n; i++)
+		link[i] = ancestor[i] = i;
+	auto find = [&link](int x){
+		while(link[x] != x){
+			link[x] = link[link[x]];
+			x = link[x];
+		}
+		return x;
+	};
+
+	//children are visited before the node is finished, then merged into the parent's set
+	vector<pair<int, int>> stack(1, make_pair(0, -1));
+	vector<char> expanded(n, 0);
+	while(!stack.empty()){
+		int u = stack.back().first;
+		int p = stack.back().second;
+		if(!expanded[u]){
+			expanded[u] = 1;
+			if(nodes[u]->right)
+				stack.push_back(make_pair(order[nodes[u]->right], u));
+			if(nodes[u]->left)
+				stack.push_back(make_pair(order[nodes[u]->left], u));
+			continue;
+		}
+		stack.pop_back();
+		done[u] = 1;
+		for(int k = first[u]; k < first[u + 1]; k++){
+			int q = pending[k];
+			int other = ends[q].first == u ? ends[q].second : ends[q].first;
+			if(done[other])
+				results[q] = nodes[ancestor[find(other)]];
+		}
+		if(p >= 0){
+			link[find(u)] = find(p);
+			ancestor[find(p)] = p;
+		}
+	}
+	return results;
+}
+
+//orders supported by treeTraversal
+//spiral visits odd levels left to right and even levels right to left, like levelOrderSpiral
+enum class traversalOrder { preOrder, inOrder, postOrder, levelOrder, spiral };
+
+//lazy traversal of a binary tree, next() returns the following node or nullptr once done
+//holds an explicit stack (depth first orders) or the current level (level orders), never recurses
+//O(1) amortized time per node, O(h) space depth first, O(width) space for level orders
+template<class V>
+class treeTraversal
+{
+public:
+	treeTraversal(treeNode<V>* root, traversalOrder order) : order(order), cur(root) {
+		if(root == nullptr)
+			return;
+		if(order == traversalOrder::preOrder)
+			stack.push_back(root);
+		else if(order == traversalOrder::levelOrder || order == traversalOrder::spiral)
+			levelNodes.push_back(root);
+	}
+
+	treeNode<V>* next(){
+		switch(order){
+		case traversalOrder::preOrder:
+			return nextPreOrder();
+		case traversalOrder::inOrder:
+			return nextInOrder();
+		case traversalOrder::postOrder:
+			return nextPostOrder();
+		default:
+			return nextLevelOrder();
+		}
+	}
+
+	//level (root is 0) of the node last returned, only tracked for level orders
+	int level() const{
+		return depth;
+	}
+
+private:
+	treeNode<V>* nextPreOrder(){
+		if(stack.empty())
+			return nullptr;
+		treeNode<V>* n = stack.back();
+		stack.pop_back();
+		if(n->right)
+			stack.push_back(n->right);
+		if(n->left)
+			stack.push_back(n->left);
+		return n;
+	}
+
+	treeNode<V>* nextInOrder(){
+		for(; cur; cur = cur->left)
+			stack.push_back(cur);
+		if(stack.empty())
+			return nullptr;
+		treeNode<V>* n = stack.back();
+		stack.pop_back();
+		cur = n->right;
+		return n;
+	}
+
+	treeNode<V>* nextPostOrder(){
+		while(cur || !stack.empty()){
+			if(cur){
+				stack.push_back(cur);
+				cur = cur->left;
+				continue;
+			}
+			//right subtree is either empty or was the last thing returned, so the node is finished
+			treeNode<V>* n = stack.back();
+			if(n->right && last != n->right){
+				cur = n->right;
+				continue;
+			}
+			stack.pop_back();
+			last = n;
+			return n;
+		}
+		return nullptr;
+	}
+
+	treeNode<V>* nextLevelOrder(){
+		if(pos == levelNodes.size()){
+			//level finished, gather the next one left to right
+			stack.clear();
+			for(size_t i = 0; i < levelNodes.size(); i++){
+				if(levelNodes[i]->left)
+					stack.push_back(levelNodes[i]->left);
+				if(levelNodes[i]->right)
+					stack.push_back(levelNodes[i]->right);
+			}
+			levelNodes.swap(stack);
+			pos = 0;
+			depth++;
+			if(levelNodes.empty())
+				return nullptr;
+		}
+		size_t i = pos++;
+		if(order == traversalOrder::spiral && depth % 2 == 0)
+			i = levelNodes.size() - 1 - i;
+		return levelNodes[i];
+	}
+
+	traversalOrder order;
+	treeNode<V>* cur;
+	treeNode<V>* last = nullptr;
+	vector<treeNode<V>*> stack;
+	vector<treeNode<V>*> levelNodes;
+	size_t pos = 0;
+	int depth = 0;
+};
+
+//calls visit on every node of root in the given order
+//O(n) time
+template<class V, class Visit>
+void forEachNode(treeNode<V>* root, traversalOrder order, Visit visit){
+	treeTraversal<V> walk(root, order);
+	while(treeNode<V>* n = walk.next())
+		visit(n);
+}
+
+//Level order traversal
+//O(n) time complexity, n = number of nodes in tree
+//prints the nodes of treeTraversal's level order
+template<class V>
+void levelOrder(treeNode<V>* root){
+	treeTraversal<V> walk(root, traversalOrder::levelOrder);
+	while(treeNode<V>* temp = walk.next())
+		cout << temp->data << " ";
+}
+
+//Level order traversal in spiral
+//O(n) time complexity, O(width) space, n = number of nodes in tree
+//prints the nodes of treeTraversal's spiral order
+template<class V>
+void levelOrderSpiral(treeNode<V>* root){
+	treeTraversal<V> walk(root, traversalOrder::spiral);
+	while(treeNode<V>* temp = walk.next())
+		cout << temp->data << " ";
+}
+
+//calls visit on every node in order using Morris threading
+//right pointers of in-order predecessors are threaded temporarily and restored before returning,
+//so visit must not change the tree and the tree must not be shared with other threads meanwhile
+//O(n) time, O(1) space
+template<class V, class Visit>
+void morrisInOrder(treeNode<V>* root, Visit visit){
+	treeNode<V>* cur = root;
+	while(cur){
+		if(cur->left == nullptr){
+			visit(cur);
+			cur = cur->right;
+			continue;
+		}
+		treeNode<V>* pred = cur->left;
+		while(pred->right && pred->right != cur)
+			pred = pred->right;
+		if(pred->right == nullptr){
+			pred->right = cur;
+			cur = cur->left;
+		}
+		else{
+			pred->right = nullptr;
+			visit(cur);
+			cur = cur->right;
+		}
+	}
+}
+
+//calls visit on every node in preorder using Morris threading, same restrictions as morrisInOrder
+//O(n) time, O(1) space
+template<class V, class Visit>
+void morrisPreOrder(treeNode<V>* root, Visit visit){
+	treeNode<V>* cur = root;
+	while(cur){
+		if(cur->left == nullptr){
+			visit(cur);
+			cur = cur->right;
+			continue;
+		}
+		treeNode<V>* pred = cur->left;
+		while(pred->right && pred->right != cur)
+			pred = pred->right;
+		if(pred->right == nullptr){
+			visit(cur);
+			pred->right = cur;
+			cur = cur->left;
+		}
+		else{
+			pred->right = nullptr;
+			cur = cur->right;
+		}
+	}
+}
+
+//calls visit(level, nodes) once per level with that level's nodes left to right, stops once visit returns false
+//O(n) time, O(width) space
+template<class V, class Visit>
+void forEachLevel(treeNode<V>* root, Visit visit){
+	vector<treeNode<V>*> level, next;
+	if(root)
+		level.push_back(root);
+	for(int depth = 0; !level.empty(); depth++){
+		if(!visit(depth, level))
+			return;
+		next.clear();
+		for(size_t i = 0; i < level.size(); i++){
+			if(level[i]->left)
+				next.push_back(level[i]->left);
+			if(level[i]->right)
+				next.push_back(level[i]->right);
+		}
+		level.swap(next);
+	}
+}
+
+//returns the nodes of each level left to right
+//O(n) time
+template<class V>
+vector<vector<treeNode<V>*>> levelLists(treeNode<V>* root){
+	vector<vector<treeNode<V>*>> levels;
+	forEachLevel(root, [&levels](int, const vector<treeNode<V>*>& level){
+		levels.push_back(level);
+		return true;
+	});
+	return levels;
+}
+
+//returns a linked list of the data on each level, left to right, in a single pass
+//lists are allocated with new like createLevelLinkedList
+//O(n) time
+template<class V>
+vector<listNode<V>*> levelLinkedLists(treeNode<V>* root){
+	vector<listNode<V>*> heads;
+	forEachLevel(root, [&heads](int, const vector<treeNode<V>*>& level){
+		listNode<V>* head = nullptr;
+		for(size_t i = level.size(); i-- > 0; ){
+			listNode<V>* temp = new listNode<V>();
+			temp->data = level[i]->data;
+			temp->next = head;
+			head = temp;
+		}
+		heads.push_back(head);
+		return true;
+	});
+	return heads;
+}
+
+//creates a linked list for all the nodes at the level specified after head, use levelLinkedLists to build every level at once
+//stops the breadth first walk at that level instead of recursing once per node above it
+//O(k) time, k = number of nodes down to and including that level
+template<class V>
+void createLevelLinkedList(treeNode<V>* root, listNode<V>* head, int level){
+	if(root == nullptr || level < 0)
+		return;
+
+	//insert in reverse so the list reads left to right after head
+	forEachLevel(root, [head, level](int depth, const vector<treeNode<V>*>& nodes){
+		if(depth != level)
+			return true;
+		for(size_t i = nodes.size(); i-- > 0; ){
+			listNode<V>* temp = new listNode<V>();
+			temp->next = head->next;
+			temp->data = nodes[i]->data;
+			head->next = temp;
+		}
+		return false;
+	});
+}
+
+//returns the first node of each level, the tree seen from the left
+//O(n) time
+template<class V>
+vector<treeNode<V>*> leftView(treeNode<V>* root){
+	vector<treeNode<V>*> view;
+	forEachLevel(root, [&view](int, const vector<treeNode<V>*>& level){
+		view.push_back(level.front());
+		return true;
+	});
+	return view;
+}
+
+//returns the last node of each level, the tree seen from the right
+//O(n) time
+template<class V>
+vector<treeNode<V>*> rightView(treeNode<V>* root){
+	vector<treeNode<V>*> view;
+	forEachLevel(root, [&view](int, const vector<treeNode<V>*>& level){
+		view.push_back(level.back());
+		return true;
+	});
+	return view;
+}
+
+//prints the nodes of a binary tree seen from the left view
+//right view is done similarly with rightView
+template<class V>
+void printLeftView(treeNode<V>* root){
+	vector<treeNode<V>*> view = leftView(root);
+	for(size_t i = 0; i < view.size(); i++)
+		cout << view[i]->data;
+}
+
+//returns the boundary anticlockwise from the root: left edge top down, leaves left to right, right edge bottom up
+//edges stop before leaves so every node appears once
+//O(n) time
+template<class V>
+vector<treeNode<V>*> boundaryView(treeNode<V>* root){
+	vector<treeNode<V>*> view;
+	if(root == nullptr)
+		return view;
+	view.push_back(root);
+	if(root->left == nullptr && root->right == nullptr)
+		return view;
+
+	for(treeNode<V>* n = root->left; n && (n->left || n->right); n = n->left ? n->left : n->right)
+		view.push_back(n);
+
+	treeTraversal<V> walk(root, traversalOrder::preOrder);
+	walk.next();
+	while(treeNode<V>* n = walk.next()){
+		if(n->left == nullptr && n->right == nullptr)
+			view.push_back(n);
+	}
+
+	size_t leaves = view.size();
+	for(treeNode<V>* n = root->right; n && (n->left || n->right); n = n->right ? n->right : n->left)
+		view.push_back(n);
+	reverse(view.begin() + leaves, view.end());
+	return view;
+}
+
+//stateful in-order cursor over a binary search tree (left <= node < right) without parent pointers
+//keeps the path from the root to the current node, so stepping never restarts from the root
+//next and prev are O(1) amortized over a scan, seek is O(h), O(h) space
+template<class V>
+class bstCursor
+{
+public:
+	bstCursor(treeNode<V>* root) : root(root) {}
+
+	//whether the cursor is on a node
+	bool valid() const{
+		return !path.empty();
+	}
+
+	//current node, cursor must be valid
+	treeNode<V>* node() const{
+		return path.back();
+	}
+
+	//moves to the smallest node, returns false if the tree is empty
+	bool first(){
+		path.clear();
+		descend(root, true);
+		return valid();
+	}
+
+	//moves to the largest node, returns false if the tree is empty
+	bool last(){
+		path.clear();
+		descend(root, false);
+		return valid();
+	}
+
+	//moves to the first node with data >= key, returns false (invalid) if there is none
+	bool seek(const V& key){
+		return seekBound(key, false);
+	}
+
+	//moves to the first node with data > key, returns false (invalid) if there is none
+	bool seekPast(const V& key){
+		return seekBound(key, true);
+	}
+
+	//moves to the in-order successor, returns false (invalid) past the largest node
+	bool next(){
+		return step(true);
+	}
+
+	//moves to the in-order predecessor, returns false (invalid) before the smallest node
+	bool prev(){
+		return step(false);
+	}
+
+private:
+	//pushes n and then its leftmost (or rightmost) descendants
+	void descend(treeNode<V>* n, bool leftwards){
+		for(; n; n = leftwards ? n->left : n->right)
+			path.push_back(n);
+	}
+
+	bool seekBound(const V& key, bool strict){
+		path.clear();
+		size_t keep = 0;
+		for(treeNode<V>* n = root; n; ){
+			path.push_back(n);
+			if(strict ? key < n->data : !(n->data < key)){
+				keep = path.size();
+				n = n->left;
+			}
+			else
+				n = n->right;
+		}
+		path.resize(keep);
+		return valid();
+	}
+
+	bool step(bool forward){
+		if(path.empty())
+			return false;
+		treeNode<V>* n = path.back();
+		treeNode<V>* child = forward ? n->right : n->left;
+		if(child){
+			descend(child, forward);
+			return true;
+		}
+		//climb until we leave a subtree on its left (forward) or right (backward) side
+		do{
+			child = path.back();
+			path.pop_back();
+		}while(!path.empty() && (forward ? path.back()->right : path.back()->left) == child);
+		return valid();
+	}
+
+	treeNode<V>* root;
+	vector<treeNode<V>*> path;
+};
+
+//calls visit on every node of a binary search tree with lo <= data < hi in order, stops early if visit returns false
+//O(h + k) time, k = number of nodes visited
+template<class V, class Visit>
+void bstForEachInRange(treeNode<V>* root, const V& lo, const V& hi, Visit visit){
+	bstCursor<V> cursor(root);
+	for(bool ok = cursor.seek(lo); ok && cursor.node()->data < hi; ok = cursor.next()){
+		if(!visit(cursor.node()))
+			return;
+	}
+}
+
+//returns the nodes of a binary search tree with lo <= data < hi in order
+//O(h + k) time, k = number of nodes returned
+template<class V>
+vector<treeNode<V>*> bstRange(treeNode<V>* root, const V& lo, const V& hi){
+	vector<treeNode<V>*> nodes;
+	bstForEachInRange(root, lo, hi, [&nodes](treeNode<V>* n){
+		nodes.push_back(n);
+		return true;
+	});
+	return nodes;
+}
+
+//B+ tree index from int keys to int values
+//inner nodes hold 16 keys (one cache line) searched with SSE2 compares, leaves are linked for range scans
+//erase does not merge underfull leaves, bulkLoad repacks the tree
+class bPlusTree
+{
+public:
+	static const int nodeKeys = 16;
+
+	struct leafNode;
+
+	//position of an entry in the leaf chain, invalid once it walks past the last leaf
+	struct iterator
+	{
+		const leafNode* leaf;
+		int pos;
+
+		bool valid() const { return leaf != nullptr; }
+		int key() const;
+		int value() const;
+		//moves to the next entry in key order
+		void next();
+	};
+
+	bPlusTree();
+	~bPlusTree();
+	bPlusTree(const bPlusTree&) = delete;
+	bPlusTree& operator=(const bPlusTree&) = delete;
+
+	size_t size() const { return count; }
+
+	//inserts key or overwrites its value
+	//O(log n) time
+	void insert(int key, int value);
+
+	//removes key, returns false if it was not present
+	//O(log n) time
+	bool erase(int key);
+
+	//looks up key, returns false if it is missing
+	//O(log n) time
+	bool find(int key, int& value) const;
+
+	//first entry with key >= key
+	//O(log n) time
+	iterator lowerBound(int key) const;
+
+	//first entry of the tree
+	iterator begin() const;
+
+	//calls visit(key, value) on every entry with lo <= key < hi
+	//O(log n + k) time
+	void forEachInRange(int lo, int hi, const function<void(int, int)>& visit) const;
+
+	//replaces the contents with strictly increasing keys and their values, filling nodes completely
+	//O(n) time
+	void bulkLoad(const vector<int>& keys, const vector<int>& values);
+
+	struct leafNode
+	{
+		int keys[nodeKeys];
+		int values[nodeKeys];
+		int count;
+		leafNode* next;
+	};
+
+private:
+	struct innerNode
+	{
+		int keys[nodeKeys];
+		void* children[nodeKeys + 1];
+		int count;
+	};
+
+	void destroy(void* node, int level);
+	const leafNode* findLeaf(int key) const;
+	bool insertAt(void* node, int level, int key, int value, int& splitKey, void*& splitNode);
+
+	void* root;
+	int height;
+	size_t count;
+};
+
+//calls visit(key, valueA, valueB) for each key present in both trees, merging their leaf chains
+//whole leaves that end below the other side's current key are skipped
+//O(n + m) time worst case
+void mergeJoin(const bPlusTree& a, const bPlusTree& b, const function<void(int, int, int)>& visit);
+
+//calls visit(key, value) for each element of the sorted array keys[0...size-1] present in the tree
+//O(n + m) time worst case
+void mergeJoin(const bPlusTree& a, const int keys[], int size, const function<void(int, int)>& visit);
+
 /*
 * Bit Manipulation
 */
@@ -324,6 +3726,60 @@ int magicIndex(int arr[], int start, int end);
 //O(n!) time
 vector<string> computePerms(string s);
 
+//rearranges arr into the next lexicographically greater permutation in place
+//returns false and leaves arr sorted ascending if arr was the last permutation
+//repeated values are fine, so looping from sorted order visits each multiset permutation once
+//O(n) time
+bool nextPermutation(int arr[], int size);
+bool nextPermutation(char str[], int size);
+
+//rearranges the k-subset comb of {0, ..., n-1} (kept ascending) into the next one in lexicographic order
+//returns false after the last subset
+//O(k) time
+bool nextCombination(int comb[], int k, int n);
+
+//calls visit on every permutation of arr, generated in place with Heap's algorithm
+//each step is a single swap, stops early if visit returns false
+//O(n!) time, O(n) space
+void heapPermutations(int arr[], int size, const function<bool(const int*, int)>& visit);
+
+//steps through the permutations of a caller owned buffer with Heap's algorithm
+//the buffer itself holds the current permutation, nothing is allocated per step
+struct heapPermuter
+{
+	int* arr;
+	int size;
+	vector<int> counters;
+	int i = 1;
+	bool done = false;
+
+	heapPermuter(int arr[], int size);
+
+	//advances arr to the next permutation, returns false once all have been produced
+	bool next();
+
+	//copies up to maxCount successive permutations (starting with the current one) into out
+	//out must hold maxCount * size ints, returns the number copied
+	int nextBatch(int out[], int maxCount);
+};
+
+//returns the lexicographic rank of a permutation of {0, ..., size-1} (Lehmer code), size <= 20
+//O(n^2) time
+unsigned long long permutationRank(const int arr[], int size);
+
+//writes the permutation of {0, ..., size-1} with the given lexicographic rank into arr, size <= 20
+//O(n^2) time
+void permutationUnrank(unsigned long long rank, int arr[], int size);
+
+//calls visit on count permutations of {0, ..., size-1} in lexicographic order starting at rank first
+//splits the permutation space into independent ranges for parallel workers
+//O(n^2 + count * n) time
+void permutationRange(unsigned long long first, unsigned long long count, int size, const function<bool(const int*, int)>& visit);
+
+//counts the distinct permutations of arr (multinomial coefficient), saturates at ULLONG_MAX
+//O(n log n) time
+unsigned long long countMultisetPermutations(const int arr[], int size);
+
 // count how many n-digit numbers whose digits add up to sum
 // an array is used to reduce time complexity of recursion
 // 1 <= n <= 100 and 1 <= sum <= 50000
@@ -337,7 +3793,8 @@ int longestCommonSubsequence(string x, string y, int m, int n);
 bool isNumPalindrome(int num);
 
 // returns the length of the longest common substring of s1 and s2
-// O(s1Size + s2Size)
+// uses a suffix automaton of s1
+// O(s1Size + s2Size) time
 int longestCommonSubstr(const string& s1, const string& s2);
 
 /*